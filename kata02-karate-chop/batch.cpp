@@ -0,0 +1,45 @@
+#include <algorithm>
+#include "main.h"
+
+// Searches in flight per group: enough independent loads to cover DRAM
+// latency, few enough to keep every cursor in registers.
+static constexpr size_t kGroup = 16;
+
+// Wednesday's [left, right) halving loop without the early exit: every target
+// in a group takes exactly the same number of steps, so the group advances in
+// lockstep and the misses of different targets overlap.
+static void chop_group(const int* first, size_t size, const int* targets, ssize_t* results, size_t count) {
+    const int* base[kGroup];
+    std::fill_n(base, count, first);
+
+    size_t length = size;
+    while (length > 1) {
+        size_t half = length / 2;
+        for (size_t j = 0; j < count; ++j) {
+            base[j] += (base[j][half - 1] < targets[j]) * half;
+        }
+        length -= half;
+        if (length > 1) {
+            for (size_t j = 0; j < count; ++j) {
+                __builtin_prefetch(base[j] + length / 2 - 1);
+            }
+        }
+    }
+
+    for (size_t j = 0; j < count; ++j) {
+        const int* it = base[j] + (*base[j] < targets[j]);
+        results[j] = (it != first + size && *it == targets[j]) ? it - first : -1;
+    }
+}
+
+void batch_chop(const std::vector<int>& array, std::span<const int> targets, std::span<ssize_t> results) {
+    size_t count = std::min(targets.size(), results.size());
+    if (array.empty()) {
+        std::fill_n(results.begin(), count, -1);
+        return;
+    }
+
+    for (size_t i = 0; i < count; i += kGroup) {
+        chop_group(array.data(), array.size(), targets.data() + i, results.data() + i, std::min(kGroup, count - i));
+    }
+}
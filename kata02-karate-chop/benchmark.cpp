@@ -1,10 +1,39 @@
+#include <algorithm>
+#include <fstream>
+#include <iterator>
 #include <iostream>
 #include <vector>
 #include <chrono>
+#include <climits>
+#include <cmath>
 #include <numeric>
+#include <random>
+#include <thread>
 #include "main.h"
+#include "chop.h"
+#include "mapped_array.h"
+#include "index_cache.h"
+#include "eytzinger.h"
+#include "stree.h"
+#include "learned.h"
+#include "btree.h"
+#include "compressed.h"
+#include "finger.h"
+
+// Drops the indexes the build-once variants cached on this thread; for the
+// billion-key array each one is gigabytes.
+void release_cached_indexes() {
+    release_cached_index<EytzingerIndex>();
+    release_cached_index<STreeIndex>();
+    release_cached_index<LearnedIndex>();
+    release_cached_index<SortedTree>();
+    release_cached_index<CompressedIndex>();
+    release_cached_index<FingerSearcher>();
+}
 
 void benchmark(ssize_t (*function)(const std::vector<int>&, int), const std::vector<int>& array, int target, const std::string& name) {
+    function(array, target);  // build-once variants build their index here, outside the timing
+
     double total_duration = 0.0;
     for (int i = 0; i < 100; ++i) {
         auto start = std::chrono::high_resolution_clock::now();
@@ -15,9 +44,311 @@ void benchmark(ssize_t (*function)(const std::vector<int>&, int), const std::vec
     }
 
     std::cout << name << ": " << (total_duration / 100) << " seconds (average over 100 runs)" << std::endl;
+    release_cached_indexes();
+}
+
+void benchmark_batch(const std::vector<int>& array, size_t count) {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> dist(0, static_cast<int>(array.size()) - 1);
+    std::vector<int> targets(count);
+    for (int& target : targets) {
+        target = dist(rng);
+    }
+    std::vector<ssize_t> results(count);
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; ++i) {
+        results[i] = monday(array, targets[i]);
+    }
+    auto end = std::chrono::steady_clock::now();
+    std::chrono::duration<double> looped = end - start;
+
+    start = std::chrono::steady_clock::now();
+    batch_chop(array, targets, results);
+    end = std::chrono::steady_clock::now();
+    std::chrono::duration<double> batched = end - start;
+
+    std::cout << "Monday loop: " << (count / looped.count()) << " lookups/second" << std::endl;
+    std::cout << "Batch chop: " << (count / batched.count()) << " lookups/second" << std::endl;
+}
+
+void benchmark_parallel(const std::vector<int>& array, size_t count) {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> dist(0, static_cast<int>(array.size()) - 1);
+    std::vector<int> targets(count);
+    for (int& target : targets) {
+        target = dist(rng);
+    }
+    std::vector<ssize_t> results(count);
+
+    unsigned max_threads = std::max(1u, std::thread::hardware_concurrency());
+    for (bool sort_targets : {false, true}) {
+        for (unsigned threads = 1; threads <= max_threads; ++threads) {
+            auto start = std::chrono::steady_clock::now();
+            parallel_chop(monday, array, targets, results, threads, sort_targets);
+            auto end = std::chrono::steady_clock::now();
+            std::chrono::duration<double> duration = end - start;
+
+            std::cout << "Parallel monday" << (sort_targets ? " (sorted)" : "") << ", " << threads
+                      << " threads: " << (count / duration.count()) << " lookups/second" << std::endl;
+        }
+    }
+}
+
+std::vector<int> make_keys(const std::string& distribution, size_t size, std::mt19937& rng) {
+    std::vector<int> keys(size);
+    if (distribution == "uniform") {
+        std::iota(keys.begin(), keys.end(), 0);
+        return keys;
+    }
+
+    if (distribution == "lognormal") {
+        std::lognormal_distribution<double> dist(0.0, 2.0);
+        for (int& key : keys) {
+            key = static_cast<int>(std::min(dist(rng) * 1e6, static_cast<double>(INT_MAX)));
+        }
+    } else {
+        // Clustered: dense runs around a thousand random centres.
+        std::uniform_int_distribution<int> centre(0, INT_MAX - 1000000);
+        std::vector<int> centres(1000);
+        for (int& c : centres) {
+            c = centre(rng);
+        }
+        std::uniform_int_distribution<size_t> pick(0, centres.size() - 1);
+        std::uniform_int_distribution<int> offset(0, 999999);
+        for (int& key : keys) {
+            key = centres[pick(rng)] + offset(rng);
+        }
+    }
+    std::sort(keys.begin(), keys.end());
+    return keys;
+}
+
+void benchmark_distributions(size_t size, size_t count) {
+    std::mt19937 rng(42);
+    for (const std::string distribution : {"uniform", "lognormal", "clustered"}) {
+        std::vector<int> keys = make_keys(distribution, size, rng);
+        std::uniform_int_distribution<size_t> pick(0, keys.size() - 1);
+        std::vector<int> targets(count);
+        for (int& target : targets) {
+            target = keys[pick(rng)];
+        }
+
+        learned(keys, targets[0]);  // build the model outside the timing
+        std::cout << distribution << ": learned index max window "
+                  << cached_index<LearnedIndex>(keys).max_window() << " keys" << std::endl;
+
+        for (auto [function, name] : {std::pair<chop_function, const char*>{monday, "Monday"},
+                                      {interpolation, "Interpolation"},
+                                      {learned, "Learned"}}) {
+            ssize_t found = 0;
+            auto start = std::chrono::steady_clock::now();
+            for (int target : targets) {
+                found += function(keys, target) >= 0;
+            }
+            auto end = std::chrono::steady_clock::now();
+            std::chrono::duration<double, std::nano> duration = end - start;
+
+            std::cout << distribution << ": " << name << ": " << (duration.count() / count) << " ns/lookup ("
+                      << found << " found)" << std::endl;
+        }
+        release_cached_indexes();
+    }
+}
+
+// Keeps lookups whose results are otherwise unused from being optimized away.
+static volatile ssize_t sink;
+
+template <typename Search>
+double lookup_ns(const Search& search, const std::vector<int>& targets) {
+    ssize_t found = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int target : targets) {
+        found += search(target) >= 0;
+    }
+    auto end = std::chrono::steady_clock::now();
+    std::chrono::duration<double, std::nano> duration = end - start;
+    sink = found;
+    return duration.count() / targets.size();
+}
+
+void benchmark_bounds(const std::vector<int>& array, size_t count) {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> dist(0, static_cast<int>(array.size()) - 1);
+    std::vector<int> targets(count);
+    for (int& target : targets) {
+        target = dist(rng);
+    }
+
+    auto std_lower = [&](int target) { return std::lower_bound(array.begin(), array.end(), target) - array.begin(); };
+    auto chop_lower = [&](int target) { return static_cast<ssize_t>(chop_lower_bound(array, target)); };
+    std::cout << "std::lower_bound: " << lookup_ns(std_lower, targets) << " ns/lookup" << std::endl;
+    std::cout << "chop_lower_bound: " << lookup_ns(chop_lower, targets) << " ns/lookup" << std::endl;
+
+    std::vector<std::pair<int, int>> ranges(count);
+    for (size_t i = 0; i < count; ++i) {
+        ranges[i] = {targets[i], targets[i] + 1000};
+    }
+    std::vector<size_t> counts(count);
+    auto start = std::chrono::steady_clock::now();
+    range_count(array, ranges, counts);
+    auto end = std::chrono::steady_clock::now();
+    std::chrono::duration<double, std::nano> duration = end - start;
+    std::cout << "range_count: " << (duration.count() / count) << " ns/range" << std::endl;
+}
+
+void benchmark_updates(const std::vector<int>& array, size_t count) {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> dist(0, static_cast<int>(array.size()) - 1);
+    std::vector<int> keys(count);
+    for (int& key : keys) {
+        key = dist(rng);
+    }
+
+    SortedTree tree(array);
+    auto search = [&](int target) { return tree.find(target); };
+    std::cout << "B+ tree lookup before updates: " << lookup_ns(search, keys) << " ns/lookup" << std::endl;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int key : keys) {
+        tree.insert(key);
+    }
+    auto end = std::chrono::steady_clock::now();
+    std::chrono::duration<double, std::nano> duration = end - start;
+    std::cout << "B+ tree insert: " << (duration.count() / count) << " ns/insert" << std::endl;
+    std::cout << "B+ tree lookup after updates: " << lookup_ns(search, keys) << " ns/lookup" << std::endl;
+
+    start = std::chrono::steady_clock::now();
+    for (int key : keys) {
+        tree.erase(key);
+    }
+    end = std::chrono::steady_clock::now();
+    duration = end - start;
+    std::cout << "B+ tree erase: " << (duration.count() / count) << " ns/erase" << std::endl;
+}
+
+void benchmark_compressed(const std::vector<int>& array, size_t count) {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<size_t> pick(0, array.size() - 1);
+    std::vector<int> targets(count);
+    for (int& target : targets) {
+        target = array[pick(rng)];
+    }
+
+    CompressedIndex index(array);
+    auto plain = [&](int target) { return monday(array, target); };
+    auto packed = [&](int target) { return index.find(target); };
+    std::cout << "Monday: " << sizeof(int) << " bytes/key, " << lookup_ns(plain, targets) << " ns/lookup" << std::endl;
+    std::cout << "Compressed: " << static_cast<double>(index.bytes()) / array.size() << " bytes/key, "
+              << lookup_ns(packed, targets) << " ns/lookup" << std::endl;
+}
+
+void benchmark_streams(const std::vector<int>& array, size_t count) {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<size_t> pick(0, array.size() - 1);
+    std::vector<int> random(count);
+    for (int& target : random) {
+        target = array[pick(rng)];
+    }
+    std::vector<int> sorted = random;
+    std::sort(sorted.begin(), sorted.end());
+    // Time-ordered events arriving slightly out of order.
+    std::vector<int> nearly = sorted;
+    std::uniform_int_distribution<size_t> jitter(0, 16);
+    for (size_t i = 0; i + 16 < nearly.size(); i += 8) {
+        std::swap(nearly[i], nearly[i + jitter(rng)]);
+    }
+
+    for (auto [targets, name] : {std::pair<const std::vector<int>*, const char*>{&sorted, "sorted"},
+                                 {&nearly, "nearly sorted"},
+                                 {&random, "random"}}) {
+        FingerSearcher searcher(array);
+        auto plain = [&](int target) { return monday(array, target); };
+        auto fingered = [&](int target) { return searcher.find(target); };
+        std::cout << "Monday, " << name << " stream: " << lookup_ns(plain, *targets) << " ns/lookup" << std::endl;
+        std::cout << "Finger, " << name << " stream: " << lookup_ns(fingered, *targets) << " ns/lookup" << std::endl;
+    }
+}
+
+void benchmark_sets(size_t large) {
+    std::mt19937 rng(42);
+    std::vector<int> b(large);
+    for (size_t i = 0; i < large; ++i) {
+        b[i] = static_cast<int>(2 * i);
+    }
+
+    for (size_t ratio : {1, 10, 100, 1000, 10000}) {
+        std::uniform_int_distribution<size_t> pick(0, 2 * large - 1);
+        std::vector<int> a(large / ratio);
+        for (int& key : a) {
+            key = static_cast<int>(pick(rng));
+        }
+        std::sort(a.begin(), a.end());
+        a.erase(std::unique(a.begin(), a.end()), a.end());
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<int> expected;
+        std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+        auto end = std::chrono::steady_clock::now();
+        std::chrono::duration<double, std::milli> standard = end - start;
+
+        start = std::chrono::steady_clock::now();
+        std::vector<int> result = sorted_intersection(a, b);
+        end = std::chrono::steady_clock::now();
+        std::chrono::duration<double, std::milli> ours = end - start;
+
+        std::cout << "Intersection 1:" << ratio << ": std::set_intersection " << standard.count()
+                  << " ms, sorted_intersection " << ours.count() << " ms" << std::endl;
+    }
 }
 
-int main() {
+void benchmark_mapped(const std::string& path, size_t count) {
+    std::mt19937 rng(42);
+    std::vector<int> targets(count);
+    {
+        MappedArray mapped(path);
+        std::uniform_int_distribution<size_t> pick(0, mapped.keys().size() - 1);
+        for (int& target : targets) {
+            target = mapped.keys()[pick(rng)];
+        }
+    }
+
+    MappedArray::evict(path);
+    {
+        MappedArray mapped(path, MapOptions{false, true, false});
+        auto search = [&](int target) { return chop::monday<int>(mapped.keys(), target); };
+        std::cout << "Mapped, cold cache: " << lookup_ns(search, targets) << " ns/lookup" << std::endl;
+        std::cout << "Mapped, warm cache: " << lookup_ns(search, targets) << " ns/lookup" << std::endl;
+    }
+    {
+        auto start = std::chrono::steady_clock::now();
+        MappedArray mapped(path, MapOptions{true, true, true});
+        auto end = std::chrono::steady_clock::now();
+        std::chrono::duration<double> duration = end - start;
+        auto search = [&](int target) { return chop::monday<int>(mapped.keys(), target); };
+        std::cout << "Mapped, populated with huge pages: " << lookup_ns(search, targets) << " ns/lookup ("
+                  << duration.count() << " seconds to map)" << std::endl;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<int> array;
+    {
+        MappedArray mapped(path);
+        array.assign(mapped.keys().begin(), mapped.keys().end());
+    }
+    auto end = std::chrono::steady_clock::now();
+    std::chrono::duration<double> duration = end - start;
+    auto search = [&](int target) { return monday(array, target); };
+    std::cout << "In-memory vector: " << lookup_ns(search, targets) << " ns/lookup ("
+              << duration.count() << " seconds to load)" << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc >= 3 && std::string(argv[1]) == "mapped") {
+        benchmark_mapped(argv[2], 1000000);
+        return 0;
+    }
+
     std::vector<int> array(1000000000);
     std::iota(array.begin(), array.end(), 0);  // Fill the vector with values from 0 to 999,999,999
     int target = 999999;
@@ -27,6 +358,24 @@ int main() {
     benchmark(wednesday, array, target, "Wednesday");
     benchmark(thursday, array, target, "Thursday");
     benchmark(friday, array, target, "Friday");
+    benchmark(eytzinger, array, target, "Eytzinger");
+    benchmark(stree, array, target, "S-tree");
+    benchmark(interpolation, array, target, "Interpolation");
+    benchmark(learned, array, target, "Learned");
+    benchmark(btree, array, target, "B+ tree");
+    benchmark(compressed, array, target, "Compressed");
+    benchmark(finger, array, target, "Finger");
+
+    benchmark_batch(array, 10000000);
+    benchmark_parallel(array, 10000000);
+    benchmark_bounds(array, 10000000);
+    benchmark_updates(array, 1000000);
+    benchmark_compressed(array, 10000000);
+    benchmark_sets(10000000);
+    benchmark_streams(array, 10000000);
+
+    array = std::vector<int>();  // release the 4 GB before generating other distributions
+    benchmark_distributions(100000000, 1000000);
 
     return 0;
 }
@@ -0,0 +1,331 @@
+#include <algorithm>
+#include <limits>
+#include "btree.h"
+#include "index_cache.h"
+#include "main.h"
+
+static constexpr unsigned kLeafKeys = 32;
+static constexpr unsigned kFanout = 16;
+static constexpr int kNoSeparator = std::numeric_limits<int>::max();
+
+struct SortedTree::Node {
+    explicit Node(bool is_leaf) : leaf(is_leaf) {}
+    virtual ~Node() = default;
+
+    bool leaf;
+    unsigned size = 0;  // keys in a leaf, children in an inner node
+};
+
+namespace {
+
+struct Leaf : SortedTree::Node {
+    Leaf() : Node(true) {}
+
+    int keys[kLeafKeys];
+    Leaf* prev = nullptr;
+    Leaf* next = nullptr;
+};
+
+// separators[i] lies between the keys of children i and i + 1; unused
+// separators hold kNoSeparator so routing can always scan all of them.
+struct Inner : SortedTree::Node {
+    Inner() : Node(false) {
+        std::fill_n(separators, kFanout - 1, kNoSeparator);
+    }
+
+    int separators[kFanout - 1];
+    size_t counts[kFanout] = {};
+    std::unique_ptr<Node> children[kFanout];
+};
+
+using Node = SortedTree::Node;
+
+Leaf* as_leaf(Node* node) { return static_cast<Leaf*>(node); }
+const Leaf* as_leaf(const Node* node) { return static_cast<const Leaf*>(node); }
+Inner* as_inner(Node* node) { return static_cast<Inner*>(node); }
+const Inner* as_inner(const Node* node) { return static_cast<const Inner*>(node); }
+
+// First child that may hold target: the number of separators below it.
+unsigned route_lower(const Inner* inner, int target) {
+    unsigned child = 0;
+    for (unsigned i = 0; i < kFanout - 1; ++i) {
+        child += inner->separators[i] < target;
+    }
+    return child;
+}
+
+// Child a new key goes to: after every separator not above it.
+unsigned route_upper(const Inner* inner, int key) {
+    unsigned child = 0;
+    for (unsigned i = 0; i + 1 < inner->size; ++i) {
+        child += inner->separators[i] <= key;
+    }
+    return child;
+}
+
+unsigned leaf_lower(const Leaf* leaf, int target) {
+    unsigned position = 0;
+    for (unsigned i = 0; i < leaf->size; ++i) {
+        position += leaf->keys[i] < target;
+    }
+    return position;
+}
+
+size_t count(const Node* node) {
+    if (node->leaf) {
+        return node->size;
+    }
+    const Inner* inner = as_inner(node);
+    size_t total = 0;
+    for (unsigned i = 0; i < inner->size; ++i) {
+        total += inner->counts[i];
+    }
+    return total;
+}
+
+// Inserts key below node. If node had to split, returns its new right
+// sibling and the separator that goes between them.
+std::unique_ptr<Node> insert(Node* node, int key, int& separator) {
+    if (node->leaf) {
+        Leaf* leaf = as_leaf(node);
+        unsigned position = std::upper_bound(leaf->keys, leaf->keys + leaf->size, key) - leaf->keys;
+        if (leaf->size < kLeafKeys) {
+            std::copy_backward(leaf->keys + position, leaf->keys + leaf->size, leaf->keys + leaf->size + 1);
+            leaf->keys[position] = key;
+            ++leaf->size;
+            return nullptr;
+        }
+
+        auto right = std::make_unique<Leaf>();
+        unsigned half = kLeafKeys / 2;
+        std::copy(leaf->keys + half, leaf->keys + kLeafKeys, right->keys);
+        right->size = kLeafKeys - half;
+        leaf->size = half;
+        right->next = leaf->next;
+        right->prev = leaf;
+        if (leaf->next) {
+            leaf->next->prev = right.get();
+        }
+        leaf->next = right.get();
+
+        int dummy;
+        insert(position <= half ? leaf : right.get(), key, dummy);
+        separator = right->keys[0];
+        return right;
+    }
+
+    Inner* inner = as_inner(node);
+    unsigned child = route_upper(inner, key);
+    int child_separator;
+    std::unique_ptr<Node> split = insert(inner->children[child].get(), key, child_separator);
+    ++inner->counts[child];
+    if (!split) {
+        return nullptr;
+    }
+
+    // Lay out all children including the new one, then refill this node and,
+    // if there are too many, a new right sibling.
+    std::unique_ptr<Node> children[kFanout + 1];
+    size_t counts[kFanout + 1];
+    int separators[kFanout];
+    unsigned total = inner->size + 1;
+    for (unsigned i = 0, j = 0; i < inner->size; ++i, ++j) {
+        children[j] = std::move(inner->children[i]);
+        counts[j] = inner->counts[i];
+        if (i + 1 < inner->size) {
+            separators[i + (i >= child)] = inner->separators[i];
+        }
+        if (i == child) {
+            counts[j] = count(children[j].get());
+            ++j;
+            counts[j] = count(split.get());
+            children[j] = std::move(split);
+            separators[child] = child_separator;
+        }
+    }
+
+    auto refill = [&](Inner* target, unsigned first, unsigned last) {
+        std::fill_n(target->separators, kFanout - 1, kNoSeparator);
+        target->size = last - first;
+        for (unsigned i = first; i < last; ++i) {
+            target->children[i - first] = std::move(children[i]);
+            target->counts[i - first] = counts[i];
+            if (i + 1 < last) {
+                target->separators[i - first] = separators[i];
+            }
+        }
+    };
+
+    if (total <= kFanout) {
+        refill(inner, 0, total);
+        return nullptr;
+    }
+
+    auto right = std::make_unique<Inner>();
+    unsigned half = total / 2;
+    refill(inner, 0, half);
+    refill(right.get(), half, total);
+    separator = separators[half - 1];
+    return right;
+}
+
+// Removes one occurrence of key below node. Children left empty are dropped.
+bool erase(Node* node, int key) {
+    if (node->leaf) {
+        Leaf* leaf = as_leaf(node);
+        unsigned position = leaf_lower(leaf, key);
+        if (position == leaf->size || leaf->keys[position] != key) {
+            return false;
+        }
+        std::copy(leaf->keys + position + 1, leaf->keys + leaf->size, leaf->keys + position);
+        if (--leaf->size == 0) {
+            if (leaf->prev) {
+                leaf->prev->next = leaf->next;
+            }
+            if (leaf->next) {
+                leaf->next->prev = leaf->prev;
+            }
+            leaf->prev = leaf->next = nullptr;
+        }
+        return true;
+    }
+
+    // Equal keys may straddle a separator, so keep going right while the
+    // separator equals key.
+    Inner* inner = as_inner(node);
+    for (unsigned child = route_lower(inner, key); child < inner->size; ++child) {
+        if (erase(inner->children[child].get(), key)) {
+            if (--inner->counts[child] == 0) {
+                unsigned separator = child > 0 ? child - 1 : 0;
+                std::move(inner->children + child + 1, inner->children + inner->size, inner->children + child);
+                std::copy(inner->counts + child + 1, inner->counts + inner->size, inner->counts + child);
+                std::copy(inner->separators + separator + 1, inner->separators + kFanout - 1,
+                          inner->separators + separator);
+                inner->separators[kFanout - 2] = kNoSeparator;
+                --inner->size;
+                inner->children[inner->size].reset();
+                if (inner->size > 0) {
+                    inner->separators[inner->size - 1] = kNoSeparator;
+                }
+            }
+            return true;
+        }
+        if (child + 1 >= inner->size || inner->separators[child] != key) {
+            break;
+        }
+    }
+    return false;
+}
+
+}
+
+SortedTree::SortedTree() : root_(std::make_unique<Leaf>()) {}
+
+SortedTree::SortedTree(const std::vector<int>& array) : size_(array.size()) {
+    std::vector<std::unique_ptr<Node>> level;
+    std::vector<int> lows;  // smallest key below each node of the level
+    Leaf* prev = nullptr;
+    for (size_t first = 0; first < array.size(); first += kLeafKeys) {
+        auto leaf = std::make_unique<Leaf>();
+        leaf->size = static_cast<unsigned>(std::min<size_t>(kLeafKeys, array.size() - first));
+        std::copy_n(array.begin() + first, leaf->size, leaf->keys);
+        leaf->prev = prev;
+        if (prev) {
+            prev->next = leaf.get();
+        }
+        prev = leaf.get();
+        lows.push_back(leaf->keys[0]);
+        level.push_back(std::move(leaf));
+    }
+    if (level.empty()) {
+        root_ = std::make_unique<Leaf>();
+        return;
+    }
+
+    while (level.size() > 1) {
+        std::vector<std::unique_ptr<Node>> parents;
+        std::vector<int> parent_lows;
+        for (size_t first = 0; first < level.size(); first += kFanout) {
+            auto inner = std::make_unique<Inner>();
+            inner->size = static_cast<unsigned>(std::min<size_t>(kFanout, level.size() - first));
+            for (unsigned i = 0; i < inner->size; ++i) {
+                inner->counts[i] = count(level[first + i].get());
+                inner->children[i] = std::move(level[first + i]);
+                if (i > 0) {
+                    inner->separators[i - 1] = lows[first + i];
+                }
+            }
+            parent_lows.push_back(lows[first]);
+            parents.push_back(std::move(inner));
+        }
+        level = std::move(parents);
+        lows = std::move(parent_lows);
+    }
+    root_ = std::move(level.front());
+}
+
+SortedTree::~SortedTree() = default;
+
+void SortedTree::insert(int key) {
+    int separator;
+    std::unique_ptr<Node> split = ::insert(root_.get(), key, separator);
+    if (split) {
+        auto root = std::make_unique<Inner>();
+        root->size = 2;
+        root->counts[0] = count(root_.get());
+        root->counts[1] = count(split.get());
+        root->separators[0] = separator;
+        root->children[0] = std::move(root_);
+        root->children[1] = std::move(split);
+        root_ = std::move(root);
+    }
+    ++size_;
+}
+
+bool SortedTree::erase(int key) {
+    if (!::erase(root_.get(), key)) {
+        return false;
+    }
+    --size_;
+
+    while (!root_->leaf && root_->size <= 1) {
+        Inner* root = as_inner(root_.get());
+        if (root->size == 1) {
+            root_ = std::move(root->children[0]);
+        } else {
+            root_ = std::make_unique<Leaf>();
+        }
+    }
+    return true;
+}
+
+ssize_t SortedTree::find(int target) const {
+    const Node* node = root_.get();
+    size_t rank = 0;
+    while (!node->leaf) {
+        const Inner* inner = as_inner(node);
+        unsigned child = route_lower(inner, target);
+        for (unsigned i = 0; i < child; ++i) {
+            rank += inner->counts[i];
+        }
+        node = inner->children[child].get();
+    }
+
+    // All keys here are below target: the lower bound, if any, starts the
+    // next leaf.
+    const Leaf* leaf = as_leaf(node);
+    unsigned position = leaf_lower(leaf, target);
+    if (position == leaf->size) {
+        leaf = leaf->next;
+        rank += position;
+        position = 0;
+        if (!leaf) {
+            return -1;
+        }
+    }
+    return leaf->keys[position] == target ? static_cast<ssize_t>(rank + position) : -1;
+}
+
+ssize_t btree(const std::vector<int>& array, int target) {
+    return cached_index<SortedTree>(array).find(target);
+}
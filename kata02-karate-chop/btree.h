@@ -0,0 +1,36 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <sys/types.h>
+
+// Updatable sorted multiset of ints: a B+ tree with 128-byte leaves chained in
+// key order and 16-way inner nodes that also count the keys below each
+// child, so lookups report the rank of a key just like an index into the
+// equivalent sorted array. Insert and erase are O(log n). Nodes emptied by
+// erase are unlinked; partly filled nodes are not merged.
+class SortedTree {
+public:
+    SortedTree();
+    // Bulk load from a sorted array.
+    explicit SortedTree(const std::vector<int>& array);
+    ~SortedTree();
+
+    SortedTree(const SortedTree&) = delete;
+    SortedTree& operator=(const SortedTree&) = delete;
+
+    void insert(int key);
+    // Removes one occurrence of key, false if there is none.
+    bool erase(int key);
+
+    // Rank of the first occurrence of target or -1.
+    ssize_t find(int target) const;
+
+    size_t size() const { return size_; }
+
+    struct Node;
+
+private:
+    std::unique_ptr<Node> root_;
+    size_t size_ = 0;
+};
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <span>
+#include <sys/types.h>
+
+// Generic versions of the daily chops. They search any contiguous sorted
+// range (vector, std::array, span over an mmap region) of keys ordered by
+// less, and compute in Index: a 32-bit Index halves the footprint of every
+// cursor for arrays under 4G elements. Not found is Index(-1), which is -1
+// for signed and the maximum value for unsigned index types. The size of the
+// array must fit in Index; that is asserted, not silently truncated.
+namespace chop {
+
+template <typename Index, typename T>
+constexpr Index index_size(std::span<const T> array) {
+    assert(array.size() <= static_cast<size_t>(std::numeric_limits<Index>::max()));
+    return static_cast<Index>(array.size());
+}
+
+template <typename T, typename Compare>
+constexpr bool equivalent(const T& a, const T& b, Compare& less) {
+    return !less(a, b) && !less(b, a);
+}
+
+template <typename T, typename Index = ssize_t, typename Compare = std::less<>>
+constexpr Index monday(std::span<const T> array, const T& target, Compare less = {}) {
+    Index l = 0;
+    Index r = index_size<Index>(array);
+
+    while (l < r) {
+        Index m = l + (r - l) / 2;
+
+        if (equivalent(array[m], target, less)) {
+            return m;
+        }
+
+        if (less(array[m], target)) {
+            l = m + 1;
+        } else {
+            r = m;
+        }
+    }
+
+    return static_cast<Index>(-1);
+}
+
+template <typename T, typename Index, typename Compare>
+constexpr Index recursive_chop(std::span<const T> array, Index left, Index right, const T& target, Compare& less) {
+    if (left == right)
+        return static_cast<Index>(-1);
+    Index middle = left + (right - left) / 2;
+    if (less(array[middle], target))
+        return recursive_chop(array, static_cast<Index>(middle + 1), right, target, less);
+    if (less(target, array[middle]))
+        return recursive_chop(array, left, middle, target, less);
+    return middle;
+}
+
+template <typename T, typename Index = ssize_t, typename Compare = std::less<>>
+constexpr Index tuesday(std::span<const T> array, const T& target, Compare less = {}) {
+    return recursive_chop(array, Index(0), index_size<Index>(array), target, less);
+}
+
+template <typename T, typename Index = ssize_t, typename Compare = std::less<>>
+constexpr Index wednesday(std::span<const T> array, const T& target, Compare less = {}) {
+    index_size<Index>(array);
+    auto left = array.begin();
+    auto right = array.end();
+    while (left != right) {
+        auto middle = left + (right - left) / 2;
+        if (equivalent(*middle, target, less))
+            return static_cast<Index>(middle - array.begin());
+        if (less(*middle, target))
+            left = middle + 1;
+        else
+            right = middle;
+    }
+    return static_cast<Index>(-1);
+}
+
+template <typename T, typename Index = ssize_t, typename Compare = std::less<>>
+constexpr Index thursday(std::span<const T> array, const T& target, Compare less = {}) {
+    Index left = 0;
+    Index right = index_size<Index>(array);
+
+    while (left < right) {
+        Index third = (right - left) / 3;
+        Index mid1 = left + third;
+        Index mid2 = right - 1 - third;
+
+        if (equivalent(array[mid1], target, less)) {
+            return mid1;
+        }
+        if (equivalent(array[mid2], target, less)) {
+            return mid2;
+        }
+
+        if (less(target, array[mid1])) {
+            right = mid1;
+        } else if (less(array[mid2], target)) {
+            left = mid2 + 1;
+        } else {
+            left = mid1 + 1;
+            right = mid2;
+        }
+    }
+
+    return static_cast<Index>(-1);
+}
+
+template <typename T, typename Index = ssize_t, typename Compare = std::less<>>
+constexpr Index friday(std::span<const T> array, const T& target, Compare less = {}) {
+    Index size = index_size<Index>(array);
+    if (size == 0) {
+        return static_cast<Index>(-1);
+    }
+
+    Index left = 0;
+    Index bound = 1;
+    while (bound < size && less(array[bound], target)) {
+        left = bound;
+        bound = bound > size / 2 ? size : bound * 2;
+    }
+
+    Index right = bound < size ? bound + 1 : size;
+    Index found = monday<T, Index>(array.subspan(left, right - left), target, less);
+    return found == static_cast<Index>(-1) ? found : left + found;
+}
+
+// Branchless lower bound over a compile-time length: every halving step is
+// its own instantiation, so the whole search unrolls into Log2(N) compares.
+template <size_t Length, typename T, typename Compare>
+constexpr size_t unrolled_lower_bound(const T* first, size_t base, const T& target, Compare& less) {
+    if constexpr (Length <= 1) {
+        return base;
+    } else {
+        constexpr size_t half = Length / 2;
+        base += less(first[base + half - 1], target) ? half : 0;
+        return unrolled_lower_bound<Length - half>(first, base, target, less);
+    }
+}
+
+template <typename T, size_t N, typename Index = ssize_t, typename Compare = std::less<>>
+constexpr Index unrolled(const std::array<T, N>& array, const T& target, Compare less = {}) {
+    static_assert(N <= static_cast<size_t>(std::numeric_limits<Index>::max()), "array too large for Index");
+    if constexpr (N == 0) {
+        return static_cast<Index>(-1);
+    } else {
+        size_t base = unrolled_lower_bound<N>(array.data(), 0, target, less);
+        base += less(array[base], target) ? 1 : 0;
+        if (base == N || less(target, array[base])) {
+            return static_cast<Index>(-1);
+        }
+        return static_cast<Index>(base);
+    }
+}
+
+}
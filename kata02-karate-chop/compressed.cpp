@@ -0,0 +1,87 @@
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include "compressed.h"
+#include "index_cache.h"
+#include "main.h"
+
+static constexpr size_t B = CompressedIndex::kBlockKeys;
+
+CompressedIndex::CompressedIndex(const std::vector<int>& array) : size_(array.size()) {
+    size_t blocks = (size_ + B - 1) / B;
+    heads_.reserve(blocks);
+    widths_.reserve(blocks);
+    starts_.reserve(blocks);
+
+    uint64_t bits = 0;
+    for (size_t first = 0; first < size_; first += B) {
+        size_t last = std::min(first + B, size_);
+        uint32_t range = static_cast<uint32_t>(array[last - 1]) - static_cast<uint32_t>(array[first]);
+        heads_.push_back(array[first]);
+        widths_.push_back(static_cast<uint8_t>(std::bit_width(range)));
+        starts_.push_back(bits);
+        bits += (last - first - 1) * widths_.back();
+    }
+
+    // Eight bytes of slack let every offset be read with one unaligned load.
+    packed_.assign(bits / 8 + 1 + sizeof(uint64_t), 0);
+    for (size_t block = 0; block < blocks; ++block) {
+        size_t first = block * B;
+        size_t last = std::min(first + B, size_);
+        uint64_t bit = starts_[block];
+        for (size_t i = first + 1; i < last; ++i, bit += widths_[block]) {
+            uint64_t value = static_cast<uint32_t>(array[i]) - static_cast<uint32_t>(array[first]);
+            uint64_t word;
+            std::memcpy(&word, packed_.data() + bit / 8, sizeof(word));
+            word |= value << (bit % 8);
+            std::memcpy(packed_.data() + bit / 8, &word, sizeof(word));
+        }
+    }
+}
+
+// Offset from the block head of key i > 0 in the block.
+uint32_t CompressedIndex::offset(size_t block, size_t i) const {
+    unsigned width = widths_[block];
+    uint64_t bit = starts_[block] + (i - 1) * width;
+    uint64_t word;
+    std::memcpy(&word, packed_.data() + bit / 8, sizeof(word));
+    return static_cast<uint32_t>((word >> (bit % 8)) & ((uint64_t(1) << width) - 1));
+}
+
+ssize_t CompressedIndex::find(int target) const {
+    auto head = std::upper_bound(heads_.begin(), heads_.end(), target);
+    if (head == heads_.begin()) {
+        return -1;
+    }
+    size_t block = head - heads_.begin() - 1;
+    size_t first = block * B;
+    if (heads_[block] == target) {
+        return first;
+    }
+
+    // Branchless lower bound over the packed offsets 1 .. length - 1; the
+    // offsets sort like the keys, so only a handful are ever unpacked.
+    uint32_t delta = static_cast<uint32_t>(target) - static_cast<uint32_t>(heads_[block]);
+    size_t keys = std::min(B, size_ - first);
+    size_t base = 1;
+    size_t length = keys - 1;
+    if (length == 0) {
+        return -1;
+    }
+    while (length > 1) {
+        size_t half = length / 2;
+        base += (offset(block, base + half - 1) < delta) * half;
+        length -= half;
+    }
+    base += offset(block, base) < delta;
+    return base < keys && offset(block, base) == delta ? static_cast<ssize_t>(first + base) : -1;
+}
+
+size_t CompressedIndex::bytes() const {
+    return heads_.size() * sizeof(int) + widths_.size() * sizeof(uint8_t) + starts_.size() * sizeof(uint64_t) +
+           packed_.size();
+}
+
+ssize_t compressed(const std::vector<int>& array, int target) {
+    return cached_index<CompressedIndex>(array).find(target);
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <sys/types.h>
+
+// Sorted ints in frame-of-reference blocks: each block of 128 keys is stored
+// as its first key plus the bit-packed offsets of the others from it, at the
+// narrowest width that fits the block. A lookup binary-searches the block
+// heads and then the packed offsets of one block in place.
+class CompressedIndex {
+public:
+    static constexpr size_t kBlockKeys = 128;
+
+    explicit CompressedIndex(const std::vector<int>& array);
+
+    // Index of target in the original array or -1.
+    ssize_t find(int target) const;
+
+    size_t bytes() const;
+
+private:
+    uint32_t offset(size_t block, size_t i) const;
+
+    size_t size_;
+    std::vector<int> heads_;
+    std::vector<uint8_t> widths_;
+    std::vector<uint64_t> starts_;  // first bit of each block in packed_
+    std::vector<uint8_t> packed_;
+};
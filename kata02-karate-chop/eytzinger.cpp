@@ -0,0 +1,57 @@
+#include <new>
+#include <limits>
+#include <stdexcept>
+#include "eytzinger.h"
+#include "index_cache.h"
+#include "main.h"
+
+// 16 ints per cache line: prefetching keys_[16k] brings in all descendants
+// of k four levels down.
+static constexpr size_t kLineInts = 64 / sizeof(int);
+static constexpr std::align_val_t kLineAlign{64};
+
+void EytzingerIndex::AlignedFree::operator()(int* p) const {
+    ::operator delete[](p, kLineAlign);
+}
+
+EytzingerIndex::EytzingerIndex(const std::vector<int>& array)
+    : size_(array.size()),
+      keys_(static_cast<int*>(::operator new[]((size_ + 1) * sizeof(int), kLineAlign))),
+      positions_(size_ + 1) {
+    if (size_ > std::numeric_limits<uint32_t>::max()) {
+        throw std::length_error("EytzingerIndex: array too large");
+    }
+    keys_[0] = 0;
+    build(array, 0, 1);
+}
+
+// In-order walk of the implicit tree hands out the sorted keys one by one.
+size_t EytzingerIndex::build(const std::vector<int>& array, size_t i, size_t k) {
+    if (k <= size_) {
+        i = build(array, i, 2 * k);
+        keys_[k] = array[i];
+        positions_[k] = static_cast<uint32_t>(i);
+        i = build(array, i + 1, 2 * k + 1);
+    }
+    return i;
+}
+
+ssize_t EytzingerIndex::find(int target) const {
+    const int* keys = keys_.get();
+    size_t k = 1;
+    while (k <= size_) {
+        __builtin_prefetch(keys + k * kLineInts);
+        k = 2 * k + (keys[k] < target);
+    }
+    // Undo the trailing right turns to land on the lower bound.
+    k >>= __builtin_ffsll(~k);
+
+    if (k == 0 || keys[k] != target) {
+        return -1;
+    }
+    return positions_[k];
+}
+
+ssize_t eytzinger(const std::vector<int>& array, int target) {
+    return cached_index<EytzingerIndex>(array).find(target);
+}
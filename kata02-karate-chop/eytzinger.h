@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <sys/types.h>
+
+// Sorted keys rearranged in Eytzinger (BFS) order: node k has children 2k and
+// 2k + 1, so the first levels of every search share a few hot cache lines and
+// the descent can prefetch its great-grandchildren in a single 64-byte line.
+class EytzingerIndex {
+public:
+    explicit EytzingerIndex(const std::vector<int>& array);
+
+    // Index of target in the original array or -1.
+    ssize_t find(int target) const;
+
+private:
+    struct AlignedFree {
+        void operator()(int* p) const;
+    };
+
+    size_t build(const std::vector<int>& array, size_t i, size_t k);
+
+    size_t size_;
+    std::unique_ptr<int[], AlignedFree> keys_;  // 1-based, keys_[0] unused
+    std::vector<uint32_t> positions_;           // original index of keys_[k]
+};
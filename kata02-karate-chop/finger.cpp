@@ -0,0 +1,45 @@
+#include <algorithm>
+#include "finger.h"
+#include "index_cache.h"
+#include "main.h"
+
+FingerSearcher::FingerSearcher(const std::vector<int>& array) : array_(array) {}
+
+ssize_t FingerSearcher::find(int target) {
+    size_t size = array_.size();
+    if (size == 0) {
+        return -1;
+    }
+    size_t finger = std::min(finger_, size - 1);
+
+    // Friday's bound doubling, in both directions: bracket the lower bound
+    // in [left, right) with array_[left - 1] < target <= array_[right].
+    size_t left, right;
+    if (array_[finger] < target) {
+        size_t bound = 1;
+        while (finger + bound < size && array_[finger + bound] < target) {
+            bound *= 2;
+        }
+        left = finger + bound / 2 + 1;
+        right = std::min(finger + bound, size);
+    } else {
+        size_t bound = 1;
+        while (bound <= finger && !(array_[finger - bound] < target)) {
+            bound *= 2;
+        }
+        left = bound <= finger ? finger - bound + 1 : 0;
+        right = finger - bound / 2;
+    }
+
+    auto it = std::lower_bound(array_.begin() + left, array_.begin() + right, target);
+    finger_ = it - array_.begin();
+    if (it == array_.end() || *it != target) {
+        return -1;
+    }
+    return finger_;
+}
+
+// The cached searcher belongs to the calling thread, so its finger is too.
+ssize_t finger(const std::vector<int>& array, int target) {
+    return cached_index<FingerSearcher>(array).find(target);
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <vector>
+#include <sys/types.h>
+
+// Searches a sorted array starting from where the previous search ended,
+// galloping outward in whichever direction the target lies, so a stream of
+// nearby targets costs O(log distance) per lookup instead of O(log n). The
+// array must outlive the searcher. A searcher is not safe to share between
+// threads; give each thread its own.
+class FingerSearcher {
+public:
+    explicit FingerSearcher(const std::vector<int>& array);
+
+    // Index of target in the array or -1; moves the finger to where target
+    // is or would be.
+    ssize_t find(int target);
+
+private:
+    const std::vector<int>& array_;
+    size_t finger_ = 0;  // the last lower bound, a hint only
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// Identity of an array: where it lives, its size and its first and last
+// keys, so a new array allocated in place of a freed one of the same size is
+// still told apart. Compared field by field, never hashed.
+struct ArrayKey {
+    const int* data = nullptr;
+    size_t size = 0;
+    int front = 0;
+    int back = 0;
+
+    bool operator==(const ArrayKey&) const = default;
+};
+
+inline ArrayKey array_key(const std::vector<int>& array) {
+    if (array.empty()) {
+        return {array.data(), 0, 0, 0};
+    }
+    return {array.data(), array.size(), array.front(), array.back()};
+}
+
+// The index of the last array the calling thread asked about.
+template <typename Index>
+struct IndexCache {
+    static inline thread_local ArrayKey key;
+    static inline thread_local std::unique_ptr<Index> index;
+};
+
+// Build-once indexes are exposed through the plain chop contract, so each
+// thread keeps the index of the last array it was asked about and rebuilds
+// it only when a different array comes in. The array must not be modified
+// between calls. The index is the calling thread's own, so stateful ones
+// (the finger searcher) may be updated through it.
+template <typename Index>
+Index& cached_index(const std::vector<int>& array) {
+    using Cache = IndexCache<Index>;
+
+    ArrayKey current = array_key(array);
+    if (!Cache::index || Cache::key != current) {
+        Cache::index.reset();
+        Cache::index = std::make_unique<Index>(array);
+        Cache::key = current;
+    }
+    return *Cache::index;
+}
+
+// Frees the calling thread's cached index, which otherwise lives as long as
+// the thread does.
+template <typename Index>
+void release_cached_index() {
+    IndexCache<Index>::index.reset();
+}
@@ -0,0 +1,44 @@
+#include "main.h"
+
+ssize_t interpolation(const std::vector<int>& array, int target) {
+    ssize_t l = 0;
+    ssize_t r = array.size() - 1;
+
+    while (l <= r && array[l] <= target && target <= array[r]) {
+        if (array[l] == array[r]) {
+            return l;
+        }
+
+        // Guess the position from the key, assuming keys are spread evenly
+        // between array[l] and array[r].
+        double fraction = (static_cast<double>(target) - array[l]) / (static_cast<double>(array[r]) - array[l]);
+        ssize_t m = l + static_cast<ssize_t>(fraction * (r - l));
+        ssize_t width = r - l;
+
+        if (array[m] == target) {
+            return m;
+        }
+
+        if (array[m] < target) {
+            l = m + 1;
+        } else {
+            r = m - 1;
+        }
+
+        // A guess that did not halve the range means the keys are not
+        // uniform here: bisect once so skewed data stays O(log n).
+        if (r - l > width / 2 && l <= r) {
+            m = l + (r - l) / 2;
+            if (array[m] == target) {
+                return m;
+            }
+            if (array[m] < target) {
+                l = m + 1;
+            } else {
+                r = m - 1;
+            }
+        }
+    }
+
+    return -1;
+}
@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <cmath>
+#include "learned.h"
+#include "index_cache.h"
+#include "main.h"
+
+// Keys per leaf model on average; small enough that the last-mile search
+// stays within a few cache lines on smooth data.
+static constexpr size_t kKeysPerLeaf = 1024;
+
+// Least-squares line through (keys[i], y(i)) for i in [first, last).
+template <typename Y>
+static auto fit(const std::vector<int>& keys, size_t first, size_t last, Y y) {
+    double n = static_cast<double>(last - first);
+    double mean_x = 0.0, mean_y = 0.0;
+    for (size_t i = first; i < last; ++i) {
+        mean_x += keys[i];
+        mean_y += y(i);
+    }
+    mean_x /= n;
+    mean_y /= n;
+
+    double cov = 0.0, var = 0.0;
+    for (size_t i = first; i < last; ++i) {
+        double dx = keys[i] - mean_x;
+        cov += dx * (y(i) - mean_y);
+        var += dx * dx;
+    }
+
+    double slope = var > 0.0 ? cov / var : 0.0;
+    return std::pair{slope, mean_y - slope * mean_x};
+}
+
+LearnedIndex::LearnedIndex(const std::vector<int>& array)
+    : array_(array),
+      leaves_(std::max<size_t>(1, array.size() / kKeysPerLeaf)) {
+    if (array.empty()) {
+        return;
+    }
+
+    double scale = static_cast<double>(leaves_.size()) / array.size();
+    auto [root_slope, root_intercept] = fit(array, 0, array.size(), [&](size_t i) { return i * scale; });
+    root_ = {root_slope, root_intercept};
+
+    // Route every key through the root; the root is monotone, so each leaf
+    // receives a contiguous run of the array.
+    std::vector<size_t> first(leaves_.size() + 1, array.size());
+    for (size_t i = array.size(); i-- > 0;) {
+        first[leaf_of(array[i])] = i;
+    }
+    for (size_t j = leaves_.size(); j-- > 0;) {
+        first[j] = std::min(first[j], first[j + 1]);
+    }
+
+    for (size_t j = 0; j < leaves_.size(); ++j) {
+        Leaf& leaf = leaves_[j];
+        if (first[j] == first[j + 1]) {
+            leaf.model = {0.0, static_cast<double>(first[j])};
+            continue;
+        }
+        auto [slope, intercept] = fit(array, first[j], first[j + 1], [](size_t i) { return static_cast<double>(i); });
+        leaf.model = {slope, intercept};
+        for (size_t i = first[j]; i < first[j + 1]; ++i) {
+            ssize_t error = predict(leaf, array[i]) - static_cast<ssize_t>(i);
+            leaf.below = std::max(leaf.below, error);
+            leaf.above = std::max(leaf.above, -error);
+        }
+    }
+}
+
+size_t LearnedIndex::leaf_of(int key) const {
+    double guess = root_(key);
+    if (!(guess > 0.0)) {
+        return 0;
+    }
+    return std::min(static_cast<size_t>(guess), leaves_.size() - 1);
+}
+
+ssize_t LearnedIndex::predict(const Leaf& leaf, int key) const {
+    double guess = std::round(leaf.model(key));
+    return static_cast<ssize_t>(std::clamp(guess, 0.0, static_cast<double>(array_.size() - 1)));
+}
+
+size_t LearnedIndex::max_window() const {
+    size_t window = 0;
+    for (const Leaf& leaf : leaves_) {
+        window = std::max(window, static_cast<size_t>(leaf.below + leaf.above + 1));
+    }
+    return window;
+}
+
+ssize_t LearnedIndex::find(int target) const {
+    if (array_.empty()) {
+        return -1;
+    }
+
+    const Leaf& leaf = leaves_[leaf_of(target)];
+    ssize_t guess = predict(leaf, target);
+    auto left = array_.begin() + std::max<ssize_t>(0, guess - leaf.below);
+    auto right = array_.begin() + std::min<ssize_t>(array_.size(), guess + leaf.above + 1);
+
+    auto it = std::lower_bound(left, right, target);
+    if (it == right || *it != target) {
+        return -1;
+    }
+    return it - array_.begin();
+}
+
+ssize_t learned(const std::vector<int>& array, int target) {
+    return cached_index<LearnedIndex>(array).find(target);
+}
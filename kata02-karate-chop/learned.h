@@ -0,0 +1,41 @@
+#pragma once
+
+#include <vector>
+#include <sys/types.h>
+
+// Two-level recursive model index over a sorted array. A linear root model
+// picks one of many linear leaf models, the leaf predicts the position of a
+// key and a binary search over the leaf's recorded error window finishes
+// the lookup. The index refers to the array, which must outlive it.
+class LearnedIndex {
+public:
+    explicit LearnedIndex(const std::vector<int>& array);
+
+    // Index of target in the array or -1.
+    ssize_t find(int target) const;
+
+    // Largest error window over all leaves, a measure of how well the
+    // models fit the key distribution.
+    size_t max_window() const;
+
+private:
+    struct Linear {
+        double slope = 0.0;
+        double intercept = 0.0;
+
+        double operator()(int key) const { return slope * key + intercept; }
+    };
+
+    struct Leaf {
+        Linear model;
+        ssize_t below = 0;  // prediction - position, worst case each way
+        ssize_t above = 0;
+    };
+
+    size_t leaf_of(int key) const;
+    ssize_t predict(const Leaf& leaf, int key) const;
+
+    const std::vector<int>& array_;
+    Linear root_;
+    std::vector<Leaf> leaves_;
+};
@@ -1,14 +1,41 @@
+#include <algorithm>
 #include <string>
 #include <iostream>
 #include <vector>
 #include <cassert>
+#include <cstdint>
+#include <type_traits>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <unistd.h>
+#include "chop.h"
+#include "mapped_array.h"
+#include "btree.h"
 #include "main.h"
 
-void run_tests(ssize_t (*function)(const std::vector<int>&, int)) {
-    std::vector<int> empty;
-    std::vector<int> one = {1};
-    std::vector<int> three = {1, 3, 5};
-    std::vector<int> four = {1, 3, 5, 7};
+template <typename T>
+static T key(int value) {
+    if constexpr (std::is_same_v<T, std::string>) {
+        return std::string(1, static_cast<char>('a' + value));
+    } else {
+        return static_cast<T>(value);
+    }
+}
+
+// Runs the daily assertions against any search over keys of type T. Not
+// found may be reported as any Index(-1), including unsigned ones.
+template <typename T, typename Function>
+void check_chop(Function search) {
+    auto function = [&](const std::vector<T>& array, int target) -> ssize_t {
+        auto result = search(array, key<T>(target));
+        return result == static_cast<decltype(result)>(-1) ? -1 : static_cast<ssize_t>(result);
+    };
+
+    std::vector<T> empty;
+    std::vector<T> one = {key<T>(1)};
+    std::vector<T> three = {key<T>(1), key<T>(3), key<T>(5)};
+    std::vector<T> four = {key<T>(1), key<T>(3), key<T>(5), key<T>(7)};
 
     assert(function(empty, 3) == -1);
     assert(function(one, 3) == -1);
@@ -29,6 +56,240 @@ void run_tests(ssize_t (*function)(const std::vector<int>&, int)) {
     assert(function(four, 4) == -1);
     assert(function(four, 6) == -1);
     assert(function(four, 8) == -1);
+}
+
+void run_tests(chop_function function) {
+    check_chop<int>(function);
+    std::cout << "All tests passed" << std::endl;
+}
+
+static ssize_t batch_single(const std::vector<int>& array, int target) {
+    ssize_t result;
+    batch_chop(array, std::span<const int>(&target, 1), std::span<ssize_t>(&result, 1));
+    return result;
+}
+
+void run_batch_tests() {
+    std::vector<int> array = {1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23, 25, 27, 29, 31, 33};
+    std::vector<int> targets;
+    for (int target = -1; target <= 35; ++target) {
+        targets.push_back(target);
+    }
+    std::vector<ssize_t> results(targets.size());
+
+    batch_chop(array, targets, results);
+    for (size_t i = 0; i < targets.size(); ++i) {
+        assert(results[i] == monday(array, targets[i]));
+    }
+
+    std::vector<int> empty;
+    batch_chop(empty, targets, results);
+    for (ssize_t result : results) {
+        assert(result == -1);
+    }
+
+    run_tests(&batch_single);
+}
+
+void run_btree_tests() {
+    // Enough keys for several levels, with runs of duplicates across leaves.
+    SortedTree tree;
+    std::vector<int> expected;
+    for (int i = 0; i < 5000; ++i) {
+        int key = (i * 7919) % 1000;
+        tree.insert(key);
+        expected.insert(std::upper_bound(expected.begin(), expected.end(), key), key);
+    }
+    for (int key = 0; key < 1000; key += 3) {
+        assert(tree.erase(key));
+        expected.erase(std::lower_bound(expected.begin(), expected.end(), key));
+    }
+    assert(!tree.erase(-1));
+    assert(tree.size() == expected.size());
+
+    for (int target = -1; target <= 1000; ++target) {
+        auto it = std::lower_bound(expected.begin(), expected.end(), target);
+        ssize_t index = it != expected.end() && *it == target ? it - expected.begin() : -1;
+        assert(tree.find(target) == index);
+    }
+
+    for (int key : std::vector<int>(expected)) {
+        assert(tree.erase(key));
+    }
+    assert(tree.size() == 0);
+    assert(tree.find(0) == -1);
+
+    run_tests(&btree);
+}
+
+void run_range_tests() {
+    std::vector<std::vector<int>> arrays = {{}, {1}, {1, 3, 5}, {1, 3, 5, 7}, {1, 1, 3, 3, 3, 5, 7, 7}, {2, 2, 2, 2}};
+    for (const std::vector<int>& array : arrays) {
+        std::vector<std::pair<int, int>> ranges;
+        for (int target = 0; target <= 8; ++target) {
+            size_t lower = std::lower_bound(array.begin(), array.end(), target) - array.begin();
+            size_t upper = std::upper_bound(array.begin(), array.end(), target) - array.begin();
+            assert(chop_lower_bound(array, target) == lower);
+            assert(chop_upper_bound(array, target) == upper);
+            assert(chop_equal_range(array, target) == std::make_pair(lower, upper));
+
+            for (int to = 0; to <= 9; ++to) {
+                ranges.emplace_back(target, to);
+            }
+        }
+
+        std::vector<size_t> counts(ranges.size());
+        range_count(array, ranges, counts);
+        for (size_t i = 0; i < ranges.size(); ++i) {
+            auto [from, to] = ranges[i];
+            size_t expected = std::count_if(array.begin(), array.end(), [&](int key) { return from <= key && key < to; });
+            assert(counts[i] == expected);
+        }
+    }
+
+    std::cout << "All tests passed" << std::endl;
+}
+
+void run_set_tests() {
+    // Multiples of 3 against multiples of 5 from both ends of the size
+    // range, so both the merge and the galloping paths are taken.
+    for (int step : {1, 7, 97, 4999}) {
+        std::vector<int> a, b;
+        for (int i = 0; i < 20000; i += 3) {
+            a.push_back(i);
+        }
+        for (int i = 0; i < 20000; i += 5 * step) {
+            b.push_back(i);
+        }
+
+        for (auto [x, y] : {std::pair{a, b}, std::pair{b, a}}) {
+            std::vector<int> expected;
+            std::set_intersection(x.begin(), x.end(), y.begin(), y.end(), std::back_inserter(expected));
+            assert(sorted_intersection(x, y) == expected);
+
+            expected.clear();
+            std::set_union(x.begin(), x.end(), y.begin(), y.end(), std::back_inserter(expected));
+            assert(sorted_union(x, y) == expected);
+
+            expected.clear();
+            std::set_difference(x.begin(), x.end(), y.begin(), y.end(), std::back_inserter(expected));
+            assert(sorted_difference(x, y) == expected);
+        }
+
+        std::vector<int> c = {0, 15, 30, 45, 60, 7500, 7501};
+        std::vector<std::span<const int>> lists = {a, b, c};
+        std::vector<int> expected;
+        for (int key : c) {
+            if (key % 3 == 0 && key % (5 * step) == 0) {
+                expected.push_back(key);
+            }
+        }
+        assert(sorted_intersection(lists) == expected);
+
+        std::vector<int> all;
+        for (int i = 0; i < 20000; ++i) {
+            if (i % 3 == 0 || i % (5 * step) == 0 || std::binary_search(c.begin(), c.end(), i)) {
+                all.push_back(i);
+            }
+        }
+        assert(sorted_union(lists) == all);
+    }
+
+    std::vector<int> empty;
+    assert(sorted_intersection(empty, {}).empty());
+    assert(sorted_union(std::span<const std::span<const int>>()).empty());
+
+    std::cout << "All tests passed" << std::endl;
+}
+
+void run_parallel_tests() {
+    std::vector<int> array;
+    for (int i = 0; i < 5000; ++i) {
+        array.push_back(2 * i);
+    }
+    std::vector<int> targets;
+    for (int i = 0; i < 20000; ++i) {
+        targets.push_back((i * 7919) % 10003 - 1);
+    }
+    std::vector<ssize_t> results(targets.size());
+
+    for (unsigned threads = 1; threads <= 4; ++threads) {
+        for (bool sort_targets : {false, true}) {
+            std::fill(results.begin(), results.end(), -2);
+            parallel_chop(&monday, array, targets, results, threads, sort_targets);
+            for (size_t i = 0; i < targets.size(); ++i) {
+                assert(results[i] == monday(array, targets[i]));
+            }
+        }
+    }
+
+    std::vector<int> empty;
+    parallel_chop(&monday, array, empty, std::span<ssize_t>(), 4);
+
+    std::cout << "All tests passed" << std::endl;
+}
+
+template <typename T, typename Index>
+void run_generic_tests() {
+    check_chop<T>([](std::span<const T> array, const T& target) { return chop::monday<T, Index>(array, target); });
+    check_chop<T>([](std::span<const T> array, const T& target) { return chop::tuesday<T, Index>(array, target); });
+    check_chop<T>([](std::span<const T> array, const T& target) { return chop::wednesday<T, Index>(array, target); });
+    check_chop<T>([](std::span<const T> array, const T& target) { return chop::thursday<T, Index>(array, target); });
+    check_chop<T>([](std::span<const T> array, const T& target) { return chop::friday<T, Index>(array, target); });
+}
+
+void run_generic_tests() {
+    run_generic_tests<int, ssize_t>();
+    run_generic_tests<int, uint32_t>();
+    run_generic_tests<uint64_t, ssize_t>();
+    run_generic_tests<uint64_t, uint32_t>();
+    run_generic_tests<float, int32_t>();
+    run_generic_tests<std::string, ssize_t>();
+
+    std::vector<int> descending = {7, 5, 3, 1};
+    assert(chop::monday<int>(descending, 3, std::greater<>()) == 2);
+    assert(chop::friday<int>(descending, 7, std::greater<>()) == 0);
+    assert(chop::thursday<int>(descending, 4, std::greater<>()) == -1);
+
+    constexpr std::array<int, 4> four = {1, 3, 5, 7};
+    static_assert(chop::unrolled(four, 1) == 0);
+    static_assert(chop::unrolled(four, 7) == 3);
+    static_assert(chop::unrolled(four, 4) == -1);
+    static_assert(chop::unrolled(four, 8) == -1);
+    static_assert(chop::unrolled(std::array<int, 0>{}, 1) == -1);
+    static_assert(chop::monday<int>(std::span<const int>(four), 5) == 2);
+
+    auto unrolled = [](int target) { return chop::unrolled(std::array<int, 3>{1, 3, 5}, target); };
+    for (int target = 0; target <= 6; ++target) {
+        assert(unrolled(target) == (target % 2 == 1 ? target / 2 : -1));
+    }
+
+    std::cout << "All tests passed" << std::endl;
+}
+
+void run_mapped_tests() {
+    char path[] = "/tmp/karate_chop_XXXXXX";
+    int fd = mkstemp(path);
+    assert(fd >= 0);
+    close(fd);
+
+    std::vector<std::vector<int>> arrays = {{}, {1}, {1, 3, 5}, {1, 3, 5, 7}};
+    for (const std::vector<int>& array : arrays) {
+        std::ofstream(path, std::ios::binary | std::ios::trunc)
+            .write(reinterpret_cast<const char*>(array.data()), array.size() * sizeof(int));
+
+        for (MapOptions options : {MapOptions{}, MapOptions{true, true, true}}) {
+            MappedArray mapped(path, options);
+            assert(mapped.keys().size() == array.size());
+            for (int target = 0; target <= 8; ++target) {
+                assert(chop::monday<int>(mapped.keys(), target) == monday(array, target));
+                assert(chop::friday<int>(mapped.keys(), target) == monday(array, target));
+            }
+        }
+    }
+
+    MappedArray::evict(path);
+    std::remove(path);
 
     std::cout << "All tests passed" << std::endl;
 }
@@ -51,6 +312,32 @@ int main(int argc, char *argv[]) {
         run_tests(&thursday);
     } else if (option == "friday") {
         run_tests(&friday);
+    } else if (option == "eytzinger") {
+        run_tests(&eytzinger);
+    } else if (option == "stree") {
+        run_tests(&stree);
+    } else if (option == "interpolation") {
+        run_tests(&interpolation);
+    } else if (option == "learned") {
+        run_tests(&learned);
+    } else if (option == "compressed") {
+        run_tests(&compressed);
+    } else if (option == "finger") {
+        run_tests(&finger);
+    } else if (option == "btree") {
+        run_btree_tests();
+    } else if (option == "batch") {
+        run_batch_tests();
+    } else if (option == "range") {
+        run_range_tests();
+    } else if (option == "sets") {
+        run_set_tests();
+    } else if (option == "parallel") {
+        run_parallel_tests();
+    } else if (option == "generic") {
+        run_generic_tests();
+    } else if (option == "mapped") {
+        run_mapped_tests();
     } else {
         std::cerr << "Invalid option" << std::endl;
         return 1;
@@ -1,7 +1,49 @@
+#pragma once
+
+#include <sys/types.h>
+#include <span>
+#include <utility>
 #include <vector>
 
+using chop_function = ssize_t (*)(const std::vector<int>& array, int target);
+
 ssize_t monday(const std::vector<int>& array, int target);
 ssize_t tuesday(const std::vector<int>& array, int target);
 ssize_t wednesday(const std::vector<int>& array, int target);
 ssize_t thursday(const std::vector<int>& array, int target);
-ssize_t friday(const std::vector<int>& array, int target);
\ No newline at end of file
+ssize_t friday(const std::vector<int>& array, int target);
+ssize_t eytzinger(const std::vector<int>& array, int target);
+ssize_t stree(const std::vector<int>& array, int target);
+ssize_t interpolation(const std::vector<int>& array, int target);
+ssize_t learned(const std::vector<int>& array, int target);
+ssize_t btree(const std::vector<int>& array, int target);
+ssize_t compressed(const std::vector<int>& array, int target);
+ssize_t finger(const std::vector<int>& array, int target);
+
+// Branchless bounds: the position of the first key not less than (lower) or
+// greater than (upper) target, and the range of keys equal to target.
+size_t chop_lower_bound(const std::vector<int>& array, int target);
+size_t chop_upper_bound(const std::vector<int>& array, int target);
+std::pair<size_t, size_t> chop_equal_range(const std::vector<int>& array, int target);
+
+// counts[i] is the number of keys in the half-open range [first, second) of ranges[i].
+void range_count(const std::vector<int>& array, std::span<const std::pair<int, int>> ranges, std::span<size_t> counts);
+
+// Set operations on strictly increasing lists. Lists of very different
+// lengths are combined by galloping through the longer one from the last
+// match, similar lengths by a linear merge.
+std::vector<int> sorted_intersection(std::span<const int> a, std::span<const int> b);
+std::vector<int> sorted_union(std::span<const int> a, std::span<const int> b);
+std::vector<int> sorted_difference(std::span<const int> a, std::span<const int> b);
+std::vector<int> sorted_intersection(std::span<const std::span<const int>> lists);
+std::vector<int> sorted_union(std::span<const std::span<const int>> lists);
+
+// Looks up every target at once, results[i] is the chop result for targets[i].
+void batch_chop(const std::vector<int>& array, std::span<const int> targets, std::span<ssize_t> results);
+
+// Spreads the targets over threads (the caller included) that share the array.
+// With sort_targets the batch is looked up in key order to improve locality.
+// The threads other than the caller are kept between calls, so build-once
+// variants build their per-thread index on the first call only.
+void parallel_chop(chop_function function, const std::vector<int>& array, std::span<const int> targets,
+                   std::span<ssize_t> results, unsigned threads, bool sort_targets = false);
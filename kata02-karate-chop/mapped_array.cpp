@@ -0,0 +1,70 @@
+#include <cerrno>
+#include <system_error>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "mapped_array.h"
+
+static std::system_error os_error(const std::string& what, int error = errno) {
+    return std::system_error(error, std::generic_category(), what);
+}
+
+MappedArray::MappedArray(const std::string& path, MapOptions options) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw os_error("open " + path);
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        int error = errno;
+        close(fd);
+        throw os_error("stat " + path, error);
+    }
+    bytes_ = static_cast<size_t>(st.st_size);
+    size_ = bytes_ / sizeof(int);
+    if (bytes_ == 0) {
+        close(fd);
+        return;
+    }
+
+    int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+    if (options.populate) {
+        flags |= MAP_POPULATE;
+    }
+#endif
+    void* data = mmap(nullptr, bytes_, PROT_READ, flags, fd, 0);
+    int error = errno;
+    close(fd);
+    if (data == MAP_FAILED) {
+        throw os_error("mmap " + path, error);
+    }
+    data_ = static_cast<const int*>(data);
+
+    if (options.random) {
+        madvise(data, bytes_, MADV_RANDOM);
+    }
+#ifdef MADV_HUGEPAGE
+    if (options.huge_pages) {
+        madvise(data, bytes_, MADV_HUGEPAGE);
+    }
+#endif
+}
+
+MappedArray::~MappedArray() {
+    if (data_) {
+        munmap(const_cast<int*>(data_), bytes_);
+    }
+}
+
+void MappedArray::evict(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw os_error("open " + path);
+    }
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+}
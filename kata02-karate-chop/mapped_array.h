@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string>
+
+struct MapOptions {
+    bool populate = false;    // MAP_POPULATE: fault every page in up front
+    bool random = false;      // MADV_RANDOM: no readahead around each probe
+    bool huge_pages = false;  // MADV_HUGEPAGE: ask for transparent huge pages
+};
+
+// A sorted array of native-endian ints stored in a binary file and mapped
+// read-only, so the chop templates search it in place without loading it.
+class MappedArray {
+public:
+    explicit MappedArray(const std::string& path, MapOptions options = {});
+    ~MappedArray();
+
+    MappedArray(const MappedArray&) = delete;
+    MappedArray& operator=(const MappedArray&) = delete;
+
+    std::span<const int> keys() const { return {data_, size_}; }
+
+    // Drops the file's clean pages from the page cache so the next mapping
+    // starts cold. Best effort, pages mapped elsewhere stay resident.
+    static void evict(const std::string& path);
+
+private:
+    const int* data_ = nullptr;
+    size_t size_ = 0;
+    size_t bytes_ = 0;
+};
@@ -0,0 +1,178 @@
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include "main.h"
+
+// Targets handed out per claim: large enough to amortize the atomic, small
+// enough that a skewed batch still leaves chunks to steal near the end.
+static constexpr size_t kChunk = 1024;
+
+namespace {
+
+// Each worker owns a contiguous run of chunks and claims them from the front.
+// Once its own run is drained it claims from the other workers' runs, so a
+// worker stuck on slow targets gets helped instead of holding up the batch.
+struct alignas(64) ChunkQueue {
+    std::atomic<size_t> next;
+    size_t end;
+};
+
+class LookupJob {
+public:
+    LookupJob(chop_function function, const std::vector<int>& array, const int* targets, ssize_t* results,
+              size_t count, unsigned workers)
+        : function_(function), array_(array), targets_(targets), results_(results), count_(count),
+          queues_(workers) {
+        size_t chunks = (count + kChunk - 1) / kChunk;
+        for (unsigned w = 0; w < workers; ++w) {
+            queues_[w].next = chunks * w / workers;
+            queues_[w].end = chunks * (w + 1) / workers;
+        }
+    }
+
+    void work(unsigned worker) {
+        for (size_t i = 0; i < queues_.size(); ++i) {
+            ChunkQueue& queue = queues_[(worker + i) % queues_.size()];
+            for (size_t chunk = queue.next++; chunk < queue.end; chunk = queue.next++) {
+                size_t first = chunk * kChunk;
+                size_t last = std::min(first + kChunk, count_);
+                for (size_t j = first; j < last; ++j) {
+                    results_[j] = function_(array_, targets_[j]);
+                }
+            }
+        }
+    }
+
+private:
+    chop_function function_;
+    const std::vector<int>& array_;
+    const int* targets_;
+    ssize_t* results_;
+    size_t count_;
+    std::vector<ChunkQueue> queues_;
+};
+
+}
+
+// Workers outlive the calls that use them, so whatever they cache per thread
+// (the indexes of the build-once variants) is built on their first call and
+// reused by later ones. The pool grows to the largest thread count asked for;
+// concurrent callers take turns.
+class WorkerPool {
+public:
+    static WorkerPool& instance() {
+        static WorkerPool pool;
+        return pool;
+    }
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (std::thread& thread : threads_) {
+            thread.join();
+        }
+    }
+
+    // Runs the job on the caller (worker 0) and threads - 1 pool workers.
+    void run(LookupJob& job, unsigned threads) {
+        std::lock_guard<std::mutex> turn(run_mutex_);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            while (threads_.size() < threads - 1) {
+                threads_.emplace_back(&WorkerPool::loop, this, static_cast<unsigned>(threads_.size()) + 1);
+            }
+            job_ = &job;
+            workers_ = threads;
+            pending_ = threads - 1;
+            ++generation_;
+        }
+        wake_.notify_all();
+        job.work(0);
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [&] { return pending_ == 0; });
+        job_ = nullptr;
+    }
+
+private:
+    WorkerPool() = default;
+
+    void loop(unsigned worker) {
+        uint64_t seen = 0;
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+            if (stop_) {
+                return;
+            }
+            seen = generation_;
+            if (worker >= workers_) {
+                continue;
+            }
+            LookupJob* job = job_;
+            lock.unlock();
+            job->work(worker);
+            lock.lock();
+            if (--pending_ == 0) {
+                done_.notify_one();
+            }
+        }
+    }
+
+    std::mutex run_mutex_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    std::vector<std::thread> threads_;
+    LookupJob* job_ = nullptr;
+    unsigned workers_ = 0;
+    unsigned pending_ = 0;
+    uint64_t generation_ = 0;
+    bool stop_ = false;
+};
+
+static void run_job(LookupJob& job, unsigned threads) {
+    if (threads == 1) {
+        job.work(0);
+        return;
+    }
+    WorkerPool::instance().run(job, threads);
+}
+
+void parallel_chop(chop_function function, const std::vector<int>& array, std::span<const int> targets,
+                   std::span<ssize_t> results, unsigned threads, bool sort_targets) {
+    size_t count = std::min(targets.size(), results.size());
+    threads = std::max(1u, threads);
+
+    if (!sort_targets) {
+        LookupJob job(function, array, targets.data(), results.data(), count, threads);
+        run_job(job, threads);
+        return;
+    }
+
+    // Sorted targets give every worker a narrow key range, so the upper
+    // levels of its searches and neighbouring probes stay in cache.
+    std::vector<size_t> order(count);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return targets[a] < targets[b]; });
+
+    std::vector<int> sorted(count);
+    for (size_t i = 0; i < count; ++i) {
+        sorted[i] = targets[order[i]];
+    }
+    std::vector<ssize_t> found(count);
+
+    LookupJob job(function, array, sorted.data(), found.data(), count, threads);
+    run_job(job, threads);
+
+    for (size_t i = 0; i < count; ++i) {
+        results[order[i]] = found[i];
+    }
+}
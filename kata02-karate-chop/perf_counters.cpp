@@ -0,0 +1,108 @@
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "perf_counters.h"
+
+struct CounterEvent {
+    const char* name;
+    uint32_t type;
+    uint64_t config;
+};
+
+static const CounterEvent kEvents[] = {
+    {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {"cache_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {"branch_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {"dtlb_misses", PERF_TYPE_HW_CACHE,
+     PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+};
+
+static int open_counter(const CounterEvent& event) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = event.type;
+    attr.config = event.config;
+    attr.disabled = 1;
+    attr.inherit = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+PerfCounters::PerfCounters() : start_(std::size(kEvents)) {
+    for (const CounterEvent& event : kEvents) {
+        fds_.push_back(open_counter(event));
+    }
+}
+
+PerfCounters::~PerfCounters() {
+    for (int fd : fds_) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+}
+
+const std::vector<std::string>& PerfCounters::names() {
+    static const std::vector<std::string> names = [] {
+        std::vector<std::string> names;
+        for (const CounterEvent& event : kEvents) {
+            names.push_back(event.name);
+        }
+        return names;
+    }();
+    return names;
+}
+
+bool PerfCounters::available() const {
+    for (int fd : fds_) {
+        if (fd >= 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void PerfCounters::start() {
+    for (size_t i = 0; i < fds_.size(); ++i) {
+        if (fds_[i] >= 0) {
+            if (read(fds_[i], start_[i].data(), sizeof(Reading)) != sizeof(Reading)) {
+                start_[i] = {};
+            }
+            ioctl(fds_[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+}
+
+void PerfCounters::stop() {
+    for (int fd : fds_) {
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+}
+
+std::vector<double> PerfCounters::values() const {
+    std::vector<double> values;
+    for (size_t i = 0; i < fds_.size(); ++i) {
+        Reading data;
+        if (fds_[i] < 0 || read(fds_[i], data.data(), sizeof(data)) != sizeof(data)) {
+            values.push_back(-1.0);
+            continue;
+        }
+        uint64_t count = data[0] - start_[i][0];
+        uint64_t enabled = data[1] - start_[i][1];
+        uint64_t running = data[2] - start_[i][2];
+        if (running == 0) {
+            values.push_back(-1.0);
+            continue;
+        }
+        values.push_back(static_cast<double>(count) * enabled / running);
+    }
+    return values;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Hardware counters for the calling thread and the threads it starts, read
+// through perf_event_open. Each counter is opened on its own, so a kernel or
+// CPU that lacks one (or forbids them all) just reports it as unavailable.
+class PerfCounters {
+public:
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    // Counter names in the order values() reports them.
+    static const std::vector<std::string>& names();
+
+    bool available() const;
+
+    void start();
+    void stop();
+
+    // Counts between start() and stop(), scaled up if the kernel had to
+    // multiplex the counters; negative for a counter that is unavailable.
+    std::vector<double> values() const;
+
+private:
+    // Value, time enabled and time running of one counter.
+    using Reading = std::array<uint64_t, 3>;
+
+    std::vector<int> fds_;
+    // Readings taken by start(). Resetting a counter does not clear what the
+    // threads it was inherited by have counted, so values() subtracts these.
+    std::vector<Reading> start_;
+};
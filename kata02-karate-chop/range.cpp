@@ -0,0 +1,70 @@
+#include <algorithm>
+#include "main.h"
+
+using const_iterator = std::vector<int>::const_iterator;
+
+// Wednesday's [left, right) halving loop, made branchless: the comparison
+// only decides how far left moves, never which way the loop goes. Returns the
+// first position in [left, right) whose key does not satisfy before.
+template <typename Before>
+static const_iterator bound_chop(const_iterator left, const_iterator right, Before before) {
+    auto length = std::distance(left, right);
+    if (length == 0) {
+        return left;
+    }
+    while (length > 1) {
+        auto half = length / 2;
+        // Both possible next probes, fetched while this compare resolves.
+        auto next = (length - half) / 2;
+        if (next > 0) {
+            __builtin_prefetch(&*(left + next - 1));
+            __builtin_prefetch(&*(left + half + next - 1));
+        }
+        left += before(left[half - 1]) * half;
+        length -= half;
+    }
+    return left + before(*left);
+}
+
+static const_iterator lower_chop(const_iterator left, const_iterator right, int target) {
+    return bound_chop(left, right, [target](int key) { return key < target; });
+}
+
+static const_iterator upper_chop(const_iterator left, const_iterator right, int target) {
+    return bound_chop(left, right, [target](int key) { return key <= target; });
+}
+
+size_t chop_lower_bound(const std::vector<int>& array, int target) {
+    return std::distance(array.cbegin(), lower_chop(array.cbegin(), array.cend(), target));
+}
+
+size_t chop_upper_bound(const std::vector<int>& array, int target) {
+    return std::distance(array.cbegin(), upper_chop(array.cbegin(), array.cend(), target));
+}
+
+std::pair<size_t, size_t> chop_equal_range(const std::vector<int>& array, int target) {
+    auto first = lower_chop(array.cbegin(), array.cend(), target);
+    auto last = upper_chop(first, array.cend(), target);
+    return {std::distance(array.cbegin(), first), std::distance(array.cbegin(), last)};
+}
+
+void range_count(const std::vector<int>& array, std::span<const std::pair<int, int>> ranges, std::span<size_t> counts) {
+    size_t count = std::min(ranges.size(), counts.size());
+    for (size_t i = 0; i < count; ++i) {
+        auto [from, to] = ranges[i];
+        if (to <= from) {
+            counts[i] = 0;
+            continue;
+        }
+        // The upper end can only lie at or after the lower one: gallop from
+        // it as friday does from the front, so short ranges stay cheap.
+        auto first = lower_chop(array.cbegin(), array.cend(), from);
+        auto remaining = std::distance(first, array.cend());
+        decltype(remaining) bound = 1;
+        while (bound < remaining && first[bound - 1] < to) {
+            bound *= 2;
+        }
+        auto last = lower_chop(first + bound / 2, first + std::min(bound, remaining), to);
+        counts[i] = std::distance(first, last);
+    }
+}
@@ -0,0 +1,185 @@
+#include <algorithm>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#include "main.h"
+
+// Size ratio from which galloping through the longer list beats a merge.
+static constexpr size_t kGallopRatio = 32;
+
+// Friday's bound doubling, started at a finger instead of at 0: the first
+// position at or after from whose key is not less than target. Costs
+// O(log distance) when consecutive targets land close together.
+static size_t gallop(std::span<const int> list, size_t from, int target) {
+    size_t bound = 1;
+    while (from + bound < list.size() && list[from + bound - 1] < target) {
+        bound *= 2;
+    }
+    auto first = list.begin() + from + bound / 2;
+    auto last = list.begin() + std::min(from + bound, list.size());
+    return std::lower_bound(first, last, target) - list.begin();
+}
+
+static void intersect_gallop(std::span<const int> small, std::span<const int> large, std::vector<int>& out) {
+    size_t finger = 0;
+    for (int key : small) {
+        finger = gallop(large, finger, key);
+        if (finger == large.size()) {
+            break;
+        }
+        if (large[finger] == key) {
+            out.push_back(key);
+        }
+    }
+}
+
+static void intersect_merge(std::span<const int> a, std::span<const int> b, std::vector<int>& out) {
+    size_t i = 0, j = 0;
+#if defined(__SSE2__)
+    // Compare four keys of each list against each other in one go by
+    // rotating one block through all four alignments.
+    while (i + 4 <= a.size() && j + 4 <= b.size()) {
+        __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a.data() + i));
+        __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b.data() + j));
+        __m128i eq = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi32(va, vb), _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1)))),
+            _mm_or_si128(_mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))),
+                         _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3)))));
+        for (unsigned mask = _mm_movemask_ps(_mm_castsi128_ps(eq)); mask; mask &= mask - 1) {
+            out.push_back(a[i + __builtin_ctz(mask)]);
+        }
+
+        int last_a = a[i + 3];
+        int last_b = b[j + 3];
+        i += (last_a <= last_b) * 4;
+        j += (last_b <= last_a) * 4;
+    }
+#endif
+    while (i < a.size() && j < b.size()) {
+        if (a[i] == b[j]) {
+            out.push_back(a[i]);
+        }
+        int key_a = a[i];
+        int key_b = b[j];
+        i += key_a <= key_b;
+        j += key_b <= key_a;
+    }
+}
+
+std::vector<int> sorted_intersection(std::span<const int> a, std::span<const int> b) {
+    if (a.size() > b.size()) {
+        std::swap(a, b);
+    }
+    std::vector<int> out;
+    out.reserve(a.size());
+    if (a.size() * kGallopRatio < b.size()) {
+        intersect_gallop(a, b, out);
+    } else {
+        intersect_merge(a, b, out);
+    }
+    return out;
+}
+
+std::vector<int> sorted_union(std::span<const int> a, std::span<const int> b) {
+    if (a.size() > b.size()) {
+        std::swap(a, b);
+    }
+    std::vector<int> out;
+    out.reserve(a.size() + b.size());
+    if (a.size() * kGallopRatio < b.size()) {
+        // Copy whole runs of the long list between consecutive short keys.
+        size_t finger = 0;
+        for (int key : a) {
+            size_t next = gallop(b, finger, key);
+            out.insert(out.end(), b.begin() + finger, b.begin() + next);
+            finger = next;
+            out.push_back(key);
+            finger += finger < b.size() && b[finger] == key;
+        }
+        out.insert(out.end(), b.begin() + finger, b.end());
+        return out;
+    }
+
+    size_t i = 0, j = 0;
+    while (i < a.size() && j < b.size()) {
+        int key_a = a[i];
+        int key_b = b[j];
+        out.push_back(std::min(key_a, key_b));
+        i += key_a <= key_b;
+        j += key_b <= key_a;
+    }
+    out.insert(out.end(), a.begin() + i, a.end());
+    out.insert(out.end(), b.begin() + j, b.end());
+    return out;
+}
+
+std::vector<int> sorted_difference(std::span<const int> a, std::span<const int> b) {
+    std::vector<int> out;
+    out.reserve(a.size());
+    if (a.size() * kGallopRatio < b.size()) {
+        size_t finger = 0;
+        for (int key : a) {
+            finger = gallop(b, finger, key);
+            if (finger == b.size() || b[finger] != key) {
+                out.push_back(key);
+            }
+        }
+    } else if (b.size() * kGallopRatio < a.size()) {
+        // Copy the runs of a between the few keys to drop.
+        size_t finger = 0;
+        for (int key : b) {
+            size_t next = gallop(a, finger, key);
+            out.insert(out.end(), a.begin() + finger, a.begin() + next);
+            finger = next + (next < a.size() && a[next] == key);
+        }
+        out.insert(out.end(), a.begin() + finger, a.end());
+    } else {
+        size_t i = 0, j = 0;
+        while (i < a.size() && j < b.size()) {
+            if (a[i] < b[j]) {
+                out.push_back(a[i++]);
+            } else {
+                i += a[i] == b[j];
+                ++j;
+            }
+        }
+        out.insert(out.end(), a.begin() + i, a.end());
+    }
+    return out;
+}
+
+std::vector<int> sorted_intersection(std::span<const std::span<const int>> lists) {
+    if (lists.empty()) {
+        return {};
+    }
+    // Smallest first: every step then only shrinks the candidate list and
+    // intersects it with a list at least as long, usually by galloping.
+    std::vector<std::span<const int>> order(lists.begin(), lists.end());
+    std::sort(order.begin(), order.end(), [](auto x, auto y) { return x.size() < y.size(); });
+
+    std::vector<int> result(order[0].begin(), order[0].end());
+    for (size_t k = 1; k < order.size() && !result.empty(); ++k) {
+        result = sorted_intersection(result, order[k]);
+    }
+    return result;
+}
+
+std::vector<int> sorted_union(std::span<const std::span<const int>> lists) {
+    if (lists.empty()) {
+        return {};
+    }
+    // Pairwise rounds: each key is copied O(log k) times.
+    std::vector<std::vector<int>> round;
+    for (size_t k = 0; k < lists.size(); k += 2) {
+        round.push_back(k + 1 < lists.size() ? sorted_union(lists[k], lists[k + 1])
+                                             : std::vector<int>(lists[k].begin(), lists[k].end()));
+    }
+    while (round.size() > 1) {
+        std::vector<std::vector<int>> next;
+        for (size_t k = 0; k < round.size(); k += 2) {
+            next.push_back(k + 1 < round.size() ? sorted_union(round[k], round[k + 1]) : std::move(round[k]));
+        }
+        round = std::move(next);
+    }
+    return std::move(round.front());
+}
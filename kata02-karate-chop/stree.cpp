@@ -0,0 +1,115 @@
+#include <new>
+#include <limits>
+#include <stdexcept>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+#include "stree.h"
+#include "index_cache.h"
+#include "main.h"
+
+static constexpr size_t B = STreeIndex::kNodeKeys;
+static constexpr std::align_val_t kLineAlign{64};
+// Padding slots sort after every real key and map to no position.
+static constexpr uint32_t kNoPosition = std::numeric_limits<uint32_t>::max();
+
+static unsigned rank_scalar(const int* node, int target) {
+    unsigned rank = 0;
+    for (size_t i = 0; i < B; ++i) {
+        rank += node[i] < target;
+    }
+    return rank;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+__attribute__((target("sse2")))
+static unsigned rank_sse2(const int* node, int target) {
+    __m128i x = _mm_set1_epi32(target);
+    unsigned mask = 0;
+    for (size_t i = 0; i < B; i += 4) {
+        __m128i keys = _mm_load_si128(reinterpret_cast<const __m128i*>(node + i));
+        mask |= static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(x, keys)))) << i;
+    }
+    return __builtin_popcount(mask);
+}
+
+__attribute__((target("avx2,popcnt")))
+static unsigned rank_avx2(const int* node, int target) {
+    __m256i x = _mm256_set1_epi32(target);
+    __m256i lo = _mm256_load_si256(reinterpret_cast<const __m256i*>(node));
+    __m256i hi = _mm256_load_si256(reinterpret_cast<const __m256i*>(node + 8));
+    unsigned mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(x, lo)))
+                  | _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(x, hi))) << 8;
+    return __builtin_popcount(mask);
+}
+#endif
+
+static STreeIndex::RankFunction select_rank() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return rank_avx2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return rank_sse2;
+    }
+#endif
+    return rank_scalar;
+}
+
+void STreeIndex::AlignedFree::operator()(int* p) const {
+    ::operator delete[](p, kLineAlign);
+}
+
+STreeIndex::STreeIndex(const std::vector<int>& array)
+    : nodes_((array.size() + B - 1) / B),
+      keys_(static_cast<int*>(::operator new[](nodes_ * B * sizeof(int), kLineAlign))),
+      positions_(nodes_ * B),
+      rank_(select_rank()) {
+    if (array.size() >= kNoPosition) {
+        throw std::length_error("STreeIndex: array too large");
+    }
+    size_t i = 0;
+    build(array, i, 0);
+}
+
+// In-order walk: left subtree of slot j, slot j, ..., right-most subtree.
+void STreeIndex::build(const std::vector<int>& array, size_t& i, size_t k) {
+    if (k >= nodes_) {
+        return;
+    }
+    for (size_t j = 0; j < B; ++j) {
+        build(array, i, k * (B + 1) + j + 1);
+        if (i < array.size()) {
+            keys_[k * B + j] = array[i];
+            positions_[k * B + j] = static_cast<uint32_t>(i);
+        } else {
+            keys_[k * B + j] = std::numeric_limits<int>::max();
+            positions_[k * B + j] = kNoPosition;
+        }
+        ++i;
+    }
+    build(array, i, k * (B + 1) + B + 1);
+}
+
+ssize_t STreeIndex::find(int target) const {
+    const int* keys = keys_.get();
+    size_t candidate = nodes_ * B;
+    size_t k = 0;
+    while (k < nodes_) {
+        unsigned rank = rank_(keys + k * B, target);
+        if (rank < B) {
+            candidate = k * B + rank;
+        }
+        k = k * (B + 1) + rank + 1;
+    }
+
+    if (candidate == nodes_ * B || keys[candidate] != target || positions_[candidate] == kNoPosition) {
+        return -1;
+    }
+    return positions_[candidate];
+}
+
+ssize_t stree(const std::vector<int>& array, int target) {
+    return cached_index<STreeIndex>(array).find(target);
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <sys/types.h>
+
+// Static B-tree with one 64-byte node of 16 sorted keys per cache line and 17
+// implicit children per node (node k has children 17k + 1 .. 17k + 17). Every
+// level touches one line and picks the branch with a single SIMD compare.
+class STreeIndex {
+public:
+    static constexpr size_t kNodeKeys = 16;
+
+    explicit STreeIndex(const std::vector<int>& array);
+
+    // Index of target in the original array or -1.
+    ssize_t find(int target) const;
+
+    // Number of keys in node that are less than target.
+    using RankFunction = unsigned (*)(const int* node, int target);
+
+private:
+    struct AlignedFree {
+        void operator()(int* p) const;
+    };
+
+    void build(const std::vector<int>& array, size_t& i, size_t k);
+
+    size_t nodes_;
+    std::unique_ptr<int[], AlignedFree> keys_;
+    std::vector<uint32_t> positions_;  // original index of keys_[j]
+    RankFunction rank_;
+};
@@ -0,0 +1,293 @@
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include "main.h"
+#include "perf_counters.h"
+
+// Benchmark suite for every search in main.h, including the bounds and
+// range counts; the set operations combine lists rather than look up keys
+// and are timed by benchmark instead. Arrays of even keys are swept
+// from L1-resident to DRAM-resident sizes; each query stream is timed as a
+// whole batch and reported per lookup as CSV or JSON. With --counters the
+// hardware counters of one extra run are reported per lookup as well.
+
+struct Options {
+    size_t min_size = 1 << 10;
+    size_t max_size = 1 << 26;
+    size_t queries = 1 << 20;
+    double hit_ratio = 1.0;
+    unsigned repeats = 3;
+    std::string format = "csv";
+    bool counters = false;
+};
+
+struct Variant {
+    std::string name;
+    std::function<void(const std::vector<int>&, std::span<const int>, std::span<ssize_t>)> run;
+};
+
+struct Result {
+    std::string variant;
+    size_t size;
+    std::string stream;
+    double hit_ratio;
+    double ns_per_lookup;
+    double cycles_per_lookup;
+    size_t found;
+    std::vector<double> counters;  // per lookup, negative when unavailable
+};
+
+static Variant single(const std::string& name, chop_function function) {
+    return {name, [function](const std::vector<int>& array, std::span<const int> targets, std::span<ssize_t> results) {
+        for (size_t i = 0; i < targets.size(); ++i) {
+            results[i] = function(array, targets[i]);
+        }
+    }};
+}
+
+// The bounds report whether target is present, so found stays comparable
+// with the chops.
+static ssize_t lower_bound_lookup(const std::vector<int>& array, int target) {
+    size_t position = chop_lower_bound(array, target);
+    return position < array.size() && array[position] == target ? static_cast<ssize_t>(position) : -1;
+}
+
+static ssize_t upper_bound_lookup(const std::vector<int>& array, int target) {
+    size_t position = chop_upper_bound(array, target);
+    return position > 0 && array[position - 1] == target ? static_cast<ssize_t>(position - 1) : -1;
+}
+
+static ssize_t equal_range_lookup(const std::vector<int>& array, int target) {
+    auto [first, last] = chop_equal_range(array, target);
+    return first < last ? static_cast<ssize_t>(first) : -1;
+}
+
+// Counts [target, target + 1) for every target; a result only records
+// whether the count was non-zero. The buffers are kept between runs.
+static Variant range_count_variant() {
+    struct Scratch {
+        std::vector<std::pair<int, int>> ranges;
+        std::vector<size_t> counts;
+    };
+    auto scratch = std::make_shared<Scratch>();
+    return {"range_count", [scratch](const std::vector<int>& array, std::span<const int> targets, std::span<ssize_t> results) {
+        scratch->ranges.resize(targets.size());
+        scratch->counts.resize(targets.size());
+        for (size_t i = 0; i < targets.size(); ++i) {
+            scratch->ranges[i] = {targets[i], targets[i] + 1};
+        }
+        range_count(array, scratch->ranges, scratch->counts);
+        for (size_t i = 0; i < targets.size(); ++i) {
+            results[i] = scratch->counts[i] > 0 ? 0 : -1;
+        }
+    }};
+}
+
+static std::vector<Variant> variants() {
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    return {
+        single("monday", monday),
+        single("tuesday", tuesday),
+        single("wednesday", wednesday),
+        single("thursday", thursday),
+        single("friday", friday),
+        single("eytzinger", eytzinger),
+        single("stree", stree),
+        single("interpolation", interpolation),
+        single("learned", learned),
+        single("btree", btree),
+        single("compressed", compressed),
+        single("finger", finger),
+        single("chop_lower_bound", lower_bound_lookup),
+        single("chop_upper_bound", upper_bound_lookup),
+        single("chop_equal_range", equal_range_lookup),
+        range_count_variant(),
+        {"batch_chop", batch_chop},
+        {"parallel_chop", [threads](const std::vector<int>& array, std::span<const int> targets, std::span<ssize_t> results) {
+            parallel_chop(monday, array, targets, results, threads);
+        }},
+    };
+}
+
+// Time stamp counter ticks; 0 where there is none.
+static uint64_t cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+// Keys are 0, 2, 4, ... so odd targets inside the range are misses.
+static std::vector<int> make_targets(size_t size, const Options& options, bool sequential, std::mt19937& rng) {
+    std::uniform_int_distribution<size_t> pick(0, size - 1);
+    std::bernoulli_distribution hit(options.hit_ratio);
+    std::vector<int> targets(options.queries);
+    for (int& target : targets) {
+        target = static_cast<int>(2 * pick(rng) + (hit(rng) ? 0 : 1));
+    }
+    if (sequential) {
+        std::sort(targets.begin(), targets.end());
+    }
+    return targets;
+}
+
+static Result measure(const Variant& variant, const std::vector<int>& array, const std::vector<int>& targets,
+                      const std::string& stream, const Options& options, PerfCounters* counters) {
+    std::vector<ssize_t> results(targets.size());
+    variant.run(array, std::span<const int>(targets).first(1), std::span<ssize_t>(results).first(1));
+
+    double best_ns = std::numeric_limits<double>::max();
+    double best_cycles = std::numeric_limits<double>::max();
+    for (unsigned r = 0; r < options.repeats; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        uint64_t start_cycles = cycles();
+        variant.run(array, targets, results);
+        uint64_t end_cycles = cycles();
+        auto end = std::chrono::steady_clock::now();
+
+        std::chrono::duration<double, std::nano> duration = end - start;
+        best_ns = std::min(best_ns, duration.count());
+        best_cycles = std::min(best_cycles, static_cast<double>(end_cycles - start_cycles));
+    }
+
+    // Counted separately so reading the counters does not skew the timings.
+    std::vector<double> counts;
+    if (counters) {
+        counters->start();
+        variant.run(array, targets, results);
+        counters->stop();
+        for (double count : counters->values()) {
+            counts.push_back(count < 0 ? count : count / targets.size());
+        }
+    }
+
+    size_t found = std::count_if(results.begin(), results.end(), [](ssize_t result) { return result >= 0; });
+    return {variant.name, array.size(), stream, options.hit_ratio,
+            best_ns / targets.size(), best_cycles / targets.size(), found, counts};
+}
+
+static void print(const std::vector<Result>& results, const std::string& format) {
+    const std::vector<std::string>& names = PerfCounters::names();
+    if (format == "json") {
+        std::cout << "[" << std::endl;
+        for (size_t i = 0; i < results.size(); ++i) {
+            const Result& r = results[i];
+            std::cout << "  {\"variant\": \"" << r.variant << "\", \"size\": " << r.size
+                      << ", \"bytes\": " << r.size * sizeof(int) << ", \"stream\": \"" << r.stream
+                      << "\", \"hit_ratio\": " << r.hit_ratio << ", \"ns_per_lookup\": " << r.ns_per_lookup
+                      << ", \"cycles_per_lookup\": " << r.cycles_per_lookup << ", \"found\": " << r.found;
+            for (size_t c = 0; c < r.counters.size(); ++c) {
+                std::cout << ", \"" << names[c] << "_per_lookup\": ";
+                if (r.counters[c] < 0) {
+                    std::cout << "null";
+                } else {
+                    std::cout << r.counters[c];
+                }
+            }
+            std::cout << "}" << (i + 1 < results.size() ? "," : "") << std::endl;
+        }
+        std::cout << "]" << std::endl;
+        return;
+    }
+
+    std::cout << "variant,size,bytes,stream,hit_ratio,ns_per_lookup,cycles_per_lookup,found";
+    if (!results.empty()) {
+        for (size_t c = 0; c < results.front().counters.size(); ++c) {
+            std::cout << "," << names[c] << "_per_lookup";
+        }
+    }
+    std::cout << std::endl;
+    for (const Result& r : results) {
+        std::cout << r.variant << "," << r.size << "," << r.size * sizeof(int) << "," << r.stream << ","
+                  << r.hit_ratio << "," << r.ns_per_lookup << "," << r.cycles_per_lookup << "," << r.found;
+        for (double count : r.counters) {
+            std::cout << ",";
+            if (count >= 0) {
+                std::cout << count;
+            }
+        }
+        std::cout << std::endl;
+    }
+}
+
+static bool parse(int argc, char *argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        size_t eq = arg.find('=');
+        std::string name = arg.substr(0, eq);
+        std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+
+        if (name == "--min-size") {
+            options.min_size = std::stoull(value);
+        } else if (name == "--max-size") {
+            options.max_size = std::stoull(value);
+        } else if (name == "--queries") {
+            options.queries = std::stoull(value);
+        } else if (name == "--hit-ratio") {
+            options.hit_ratio = std::stod(value);
+        } else if (name == "--repeats") {
+            options.repeats = std::max(1, std::stoi(value));
+        } else if (name == "--counters" && value.empty()) {
+            options.counters = true;
+        } else if (name == "--format" && (value == "csv" || value == "json")) {
+            options.format = value;
+        } else {
+            return false;
+        }
+    }
+    return options.min_size > 0 && options.min_size <= options.max_size && options.queries > 0 &&
+           options.hit_ratio >= 0.0 && options.hit_ratio <= 1.0 &&
+           options.max_size <= static_cast<size_t>(std::numeric_limits<int>::max()) / 2;
+}
+
+int main(int argc, char *argv[]) {
+    Options options;
+    if (!parse(argc, argv, options)) {
+        std::cerr << "Usage: " << argv[0]
+                  << " [--min-size=N] [--max-size=N] [--queries=N] [--hit-ratio=R] [--repeats=N]"
+                     " [--format=csv|json] [--counters]" << std::endl;
+        return 1;
+    }
+
+    std::unique_ptr<PerfCounters> counters;
+    if (options.counters) {
+        counters = std::make_unique<PerfCounters>();
+        if (!counters->available()) {
+            std::cerr << "Hardware counters unavailable (see /proc/sys/kernel/perf_event_paranoid)"
+                      << ", reporting timings only" << std::endl;
+            counters.reset();
+        }
+    }
+
+    std::mt19937 rng(42);
+    std::vector<Variant> all = variants();
+    std::vector<Result> results;
+    for (size_t size = options.min_size; size <= options.max_size; size *= 4) {
+        std::vector<int> array(size);
+        for (size_t i = 0; i < size; ++i) {
+            array[i] = static_cast<int>(2 * i);
+        }
+
+        for (bool sequential : {false, true}) {
+            std::vector<int> targets = make_targets(size, options, sequential, rng);
+            for (const Variant& variant : all) {
+                results.push_back(measure(variant, array, targets, sequential ? "sequential" : "random", options, counters.get()));
+                std::cerr << results.back().variant << " " << size << " " << results.back().stream << std::endl;
+            }
+        }
+    }
+
+    print(results, options.format);
+    return 0;
+}
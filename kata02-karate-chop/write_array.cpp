@@ -0,0 +1,35 @@
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+// Writes the keys 0 .. count - 1 as native-endian ints, the same array the
+// benchmark builds in memory, for use with MappedArray.
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <file> <count>" << std::endl;
+        return 1;
+    }
+
+    std::ofstream file(argv[1], std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "Failed to open file." << std::endl;
+        return 1;
+    }
+
+    size_t count = std::stoull(argv[2]);
+    std::vector<int> chunk(1 << 20);
+    for (size_t first = 0; first < count; first += chunk.size()) {
+        size_t length = std::min(chunk.size(), count - first);
+        std::iota(chunk.begin(), chunk.begin() + length, static_cast<int>(first));
+        file.write(reinterpret_cast<const char*>(chunk.data()), length * sizeof(int));
+    }
+
+    if (!file) {
+        std::cerr << "Failed to write file." << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,339 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <spawn.h>
+#include <string>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "aggregate.h"
+#include "batch.h"
+#ifdef HAVE_ZLIB
+#include "compressed_reader.h"
+#include <zlib.h>
+#endif
+#include "generate.h"
+#include "mapped_file.h"
+#include "table_cache.h"
+#include "watch.h"
+#include "weather.h"
+
+// Times a parser over the file and prints throughput and its answer.
+template <typename Parse>
+static void measure(const std::string& name, size_t bytes, Parse parse) {
+    auto start = std::chrono::steady_clock::now();
+    MinSpread result = parse();
+    auto end = std::chrono::steady_clock::now();
+    std::chrono::duration<double> duration = end - start;
+
+    std::cout << name << ": " << duration.count() << " seconds, " << (bytes / duration.count() / 1e6)
+              << " MB/s, day " << result.day << " (spread " << result.spread << ")" << std::endl;
+}
+
+static void bench_parse(const std::string& path, size_t bytes) {
+    measure("istringstream per line", bytes, [&] {
+        std::ifstream file(path);
+        return min_spread_stream(file);
+    });
+    measure("mmap + from_chars", bytes, [&] {
+        MappedFile file(path);
+        return min_spread_text(file.data());
+    });
+}
+
+static void bench_simd(const std::string& path, size_t bytes) {
+    MappedFile file(path);
+    measure("mmap + from_chars", bytes, [&] { return min_spread_text(file.data()); });
+    measure("mmap + SIMD scanner", bytes, [&] { return min_spread_simd(file.data()); });
+}
+
+static void bench_schema(const std::string& path, size_t bytes) {
+    MappedFile file(path);
+    measure("mmap + from_chars", bytes, [&] { return min_spread_text(file.data()); });
+    measure("schema parser (Dy, MxT, MnT)", bytes, [&] { return min_spread_schema(file.data()); });
+}
+
+#ifdef HAVE_ZLIB
+// Compresses path into compressed at the fastest level.
+static bool compress_file(const std::string& path, const std::string& compressed) {
+    MappedFile file(path);
+    gzFile out = gzopen(compressed.c_str(), "wb1");
+    if (!file.is_open() || !out) {
+        return false;
+    }
+    std::string_view text = file.data();
+    bool ok = true;
+    for (size_t offset = 0; ok && offset < text.size(); offset += 1 << 20) {
+        size_t size = std::min<size_t>(text.size() - offset, 1 << 20);
+        ok = gzwrite(out, text.data() + offset, static_cast<unsigned>(size)) == static_cast<int>(size);
+    }
+    return gzclose(out) == Z_OK && ok;
+}
+
+// The current way: inflate to a file on disk, then parse that.
+static MinSpread decompress_then_parse(const std::string& compressed, const std::string& inflated) {
+    gzFile in = gzopen(compressed.c_str(), "rb");
+    std::ofstream out(inflated, std::ios::binary | std::ios::trunc);
+    std::vector<char> buffer(1 << 20);
+    int bytes;
+    while (in && (bytes = gzread(in, buffer.data(), static_cast<unsigned>(buffer.size()))) > 0) {
+        out.write(buffer.data(), bytes);
+    }
+    if (in) {
+        gzclose(in);
+    }
+    out.close();
+    MappedFile file(inflated);
+    MinSpread result = min_spread_text(file.data());
+    std::remove(inflated.c_str());
+    return result;
+}
+
+static int bench_gzip(const std::string& path, size_t bytes) {
+    std::string compressed = path + ".gz";
+    struct stat st;
+    if (stat(compressed.c_str(), &st) != 0) {
+        std::cout << "Compressing " << path << " into " << compressed << std::endl;
+        if (!compress_file(path, compressed)) {
+            std::cerr << "Failed to write " << compressed << std::endl;
+            return 1;
+        }
+    }
+    measure("decompress to file, then parse", bytes,
+            [&] { return decompress_then_parse(compressed, path + ".inflated"); });
+    measure("pipelined decompress + parse", bytes, [&] { return min_spread_gzip(compressed).value_or(MinSpread()); });
+    return 0;
+}
+#endif
+
+static void bench_threads(const std::string& path, size_t bytes) {
+    MappedFile file(path);
+    unsigned most = std::max(std::thread::hardware_concurrency(), 1u);
+    // Warm the page cache and the mapping so that every run parses only.
+    min_spread_rows(file.data());
+    for (unsigned threads = 1; threads <= most; ++threads) {
+        measure(std::to_string(threads) + " thread(s)", bytes,
+                [&] { return min_spread_parallel(file.data(), threads); });
+    }
+}
+
+// Times loading the file as a table and prints throughput and row count.
+template <typename Load>
+static void measure_table(const std::string& name, size_t bytes, Load load) {
+    auto start = std::chrono::steady_clock::now();
+    std::optional<Table> table = load();
+    auto end = std::chrono::steady_clock::now();
+    std::chrono::duration<double> duration = end - start;
+
+    std::cout << name << ": " << duration.count() << " seconds, " << (bytes / duration.count() / 1e6) << " MB/s, "
+              << (table ? table->rows() : 0) << " rows" << std::endl;
+}
+
+static void bench_cache(const std::string& path, size_t bytes) {
+    std::remove(table_cache_path(path).c_str());
+    measure_table("text parse", bytes, [&] { return load_table(path, false); });
+    measure_table("text parse + write sidecar", bytes, [&] { return load_table(path); });
+    measure_table("sidecar load", bytes, [&] { return load_table(path); });
+}
+
+// The aggregates part1 --mode=aggregate prints by default.
+static const char* const AGGREGATES[] = {"min:MxT-MnT", "max:MxT-MnT", "avg:MxT-MnT", "avg:AvT",
+                                         "top3:MxT-MnT", "p50:MxT-MnT", "p90:MxT-MnT"};
+
+static void bench_aggregates(const std::string& path, size_t bytes) {
+    std::vector<AggregateSpec> specs;
+    for (const char* text : AGGREGATES) {
+        specs.push_back(*parse_aggregate(text));
+    }
+    MappedFile file(path);
+    auto run = [&](const std::string& name, bool fused) {
+        auto start = std::chrono::steady_clock::now();
+        std::vector<AggregateResult> results;
+        if (fused) {
+            results = run_aggregates(file.data(), specs);
+        } else {
+            for (const AggregateSpec& spec : specs) {
+                results.push_back(run_aggregates(file.data(), {spec})[0]);
+            }
+        }
+        auto end = std::chrono::steady_clock::now();
+        std::chrono::duration<double> duration = end - start;
+        std::cout << name << ": " << duration.count() << " seconds, " << (bytes / duration.count() / 1e6)
+                  << " MB/s of input, p90 " << (results.back().values.empty() ? 0 : results.back().values[0].value)
+                  << std::endl;
+    };
+    run("one pass per aggregate", false);
+    run("all aggregates in one pass", true);
+}
+
+// Time to take in one appended row, on a small file and on one of the
+// benchmark's size.
+static void bench_watch(const std::string& path, size_t bytes) {
+    const int appends = 100;
+    for (size_t size : {size_t(1000000), bytes}) {
+        std::string watched = path + ".watch";
+        if (!generate_weather(watched, size)) {
+            std::cerr << "Failed to write " << watched << std::endl;
+            return;
+        }
+
+        WatchState state;
+        auto start = std::chrono::steady_clock::now();
+        catch_up(watched, state);
+        std::chrono::duration<double> first = std::chrono::steady_clock::now() - start;
+
+        std::chrono::duration<double> total(0);
+        for (int i = 0; i < appends; ++i) {
+            {
+                std::ofstream out(watched, std::ios::app);
+                out << "  15  70    " << (20 + i % 40) << "    50.0    0    53.8  0.00  0.00\n";
+            }
+            start = std::chrono::steady_clock::now();
+            catch_up(watched, state);
+            total += std::chrono::steady_clock::now() - start;
+        }
+        std::remove(watched.c_str());
+
+        std::cout << size / 1000000 << " MB file: first read " << first.count() << " seconds, then "
+                  << total.count() / appends * 1e6 << " us per appended row, day " << state.result.day << std::endl;
+    }
+}
+
+// Times one way of answering every file and prints files per second.
+template <typename Run>
+static void measure_files(const std::string& name, size_t count, Run run) {
+    auto start = std::chrono::steady_clock::now();
+    bool ok = run();
+    auto end = std::chrono::steady_clock::now();
+    std::chrono::duration<double> duration = end - start;
+
+    std::cout << name << ": " << duration.count() << " seconds, " << (count / duration.count()) << " files/s"
+              << (ok ? "" : " (failed)") << std::endl;
+}
+
+// Starts part1 once per file, as a shell loop over the files would.
+static bool run_per_process(const std::string& part1, const std::vector<std::string>& paths) {
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+    bool ok = true;
+    for (const std::string& path : paths) {
+        char* args[] = {const_cast<char*>(part1.c_str()), const_cast<char*>(path.c_str()), nullptr};
+        pid_t pid;
+        int status = 0;
+        ok = ok && posix_spawn(&pid, part1.c_str(), &actions, nullptr, args, environ) == 0 &&
+             waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    }
+    posix_spawn_file_actions_destroy(&actions);
+    return ok;
+}
+
+// Drops the files from the page cache so that the next run reads the disk.
+static void evict(const std::vector<std::string>& paths) {
+    for (const std::string& path : paths) {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd >= 0) {
+            fdatasync(fd);
+            posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+            close(fd);
+        }
+    }
+}
+
+static int bench_batch(const std::string& self, const std::string& directory, size_t count) {
+    std::vector<std::string> paths = list_directory(directory);
+    if (paths.size() < count) {
+        std::cout << "Generating " << count << " station files into " << directory << std::endl;
+        mkdir(directory.c_str(), 0755);
+        paths.clear();
+        for (size_t i = 0; i < count; ++i) {
+            paths.push_back(directory + "/station" + std::to_string(i) + ".dat");
+            if (!generate_weather(paths.back(), 3000, static_cast<unsigned>(i))) {
+                std::cerr << "Failed to write " << paths.back() << std::endl;
+                return 1;
+            }
+        }
+    }
+    paths.resize(count);
+
+    std::string part1 = self.substr(0, self.find_last_of('/') + 1) + "part1";
+    auto all_ok = [](const std::vector<FileResult>& files) {
+        return std::all_of(files.begin(), files.end(), [](const FileResult& file) { return file.ok; });
+    };
+    BatchOptions threads;
+    threads.io = BatchIo::Threads;
+    for (bool cold : {true, false}) {
+        std::string cache = cold ? " (cold cache)" : " (warm cache)";
+        if (cold) {
+            evict(paths);
+        }
+        measure_files("one part1 process per file" + cache, count, [&] { return run_per_process(part1, paths); });
+        if (cold) {
+            evict(paths);
+        }
+        measure_files("batch, thread pool" + cache, count, [&] { return all_ok(min_spread_files(paths, threads)); });
+        if (cold) {
+            evict(paths);
+        }
+        measure_files("batch, io_uring" + cache, count, [&] { return all_ok(min_spread_files(paths)); });
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <parse|simd|schema|gzip|threads|cache|aggregates|watch> [file] [megabytes]" << std::endl;
+        std::cerr << "       " << argv[0] << " batch [directory] [files]" << std::endl;
+        return 1;
+    }
+    std::string section = argv[1];
+    if (section == "batch") {
+        return bench_batch(argv[0], argc > 2 ? argv[2] : "/tmp/weather_stations",
+                           argc > 3 ? std::stoull(argv[3]) : 2000);
+    }
+    std::string path = argc > 2 ? argv[2] : "/tmp/weather_large.dat";
+    size_t megabytes = argc > 3 ? std::stoull(argv[3]) : 1024;
+
+    // Generate the input once and reuse it on later runs.
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0 || static_cast<size_t>(st.st_size) < megabytes * 1000000) {
+        std::cout << "Generating " << megabytes << " MB into " << path << std::endl;
+        if (!generate_weather(path, megabytes * 1000000)) {
+            std::cerr << "Failed to write " << path << std::endl;
+            return 1;
+        }
+        stat(path.c_str(), &st);
+    }
+    size_t bytes = static_cast<size_t>(st.st_size);
+
+    if (section == "parse") {
+        bench_parse(path, bytes);
+    } else if (section == "simd") {
+        bench_simd(path, bytes);
+    } else if (section == "schema") {
+        bench_schema(path, bytes);
+#ifdef HAVE_ZLIB
+    } else if (section == "gzip") {
+        return bench_gzip(path, bytes);
+#endif
+    } else if (section == "threads") {
+        bench_threads(path, bytes);
+    } else if (section == "cache") {
+        bench_cache(path, bytes);
+    } else if (section == "watch") {
+        bench_watch(path, bytes);
+    } else if (section == "aggregates") {
+        bench_aggregates(path, bytes);
+    } else {
+        std::cerr << "Unknown benchmark " << section << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,43 @@
+#include "generate.h"
+
+#include <cstdio>
+#include <fstream>
+#include <random>
+
+bool generate_weather(const std::string& path, size_t bytes, unsigned seed) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    std::mt19937 rng(seed);
+    // Temperatures stay within two characters so that rows keep their
+    // fixed-width columns.
+    std::uniform_int_distribution<int> temp(31, 99);
+    std::uniform_int_distribution<int> spread(1, 40);
+    std::uniform_int_distribution<int> rare(0, 999);
+
+    file << "  Dy MxT   MnT   AvT   HDDay  AvDP 1HrP TPcpn WxType PDir AvSp Dir MxS SkyC MxR MnR AvSLP\n";
+    size_t written = 0;
+    char row[160];
+    for (unsigned long long i = 0; written < bytes; ++i) {
+        int day = static_cast<int>(i % 31) + 1;
+        int maxTemp = temp(rng);
+        int minTemp = maxTemp - spread(rng);
+        int kind = rare(rng);
+        int length;
+        if (kind == 0) {
+            // Summary rows keep to the columns of the day rows.
+            length = std::snprintf(row, sizeof(row), "  mo  %2d.2  %2d.1  %4.1f    0    53.8  0.00  6.64\n",
+                                   maxTemp, minTemp, (maxTemp + minTemp) / 2.0);
+        } else {
+            length = std::snprintf(row, sizeof(row),
+                                   "  %2d  %2d%s   %2d%s   %4.1f    0    53.8  0.00  0.00  F     280  9.6  270 17  1.6  93  23  1004.5\n",
+                                   day, maxTemp, kind == 1 ? "*" : " ", minTemp, kind == 2 ? "*" : " ",
+                                   (maxTemp + minTemp) / 2.0);
+        }
+        file.write(row, length);
+        written += static_cast<size_t>(length);
+    }
+    return static_cast<bool>(file);
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// Writes a weather.dat-style file of about the given size: the usual header,
+// then rows of random readings, with the odd "*"-flagged value and "mo"
+// summary row that part1 has to skip. Returns false if it cannot be written.
+bool generate_weather(const std::string& path, size_t bytes, unsigned seed = 42);
@@ -0,0 +1,267 @@
+#include "aggregate.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <random>
+
+#include "table.h"
+
+namespace {
+
+// Rows read up front to find the fixed-width columns.
+const size_t SAMPLE_ROWS = 1000;
+// Samples kept per quantile.
+const size_t RESERVOIR = 4096;
+
+struct Expression {
+    size_t left = 0;
+    // 0 for a plain column
+    char op = 0;
+    size_t right = 0;
+};
+
+// Running state of one aggregate.
+struct State {
+    Expression expression;
+    double sum = 0;
+    std::vector<AggregateValue> kept;
+    std::vector<double> samples;
+    std::mt19937_64 rng{42};
+};
+
+bool is_data_row(std::string_view line) {
+    return std::any_of(line.begin(), line.end(), [](char c) {
+        return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+    });
+}
+
+// A whole cell holding an int, allowing the trailing '*' flag.
+bool is_int(std::string_view cell) {
+    int value;
+    auto result = std::from_chars(cell.data(), cell.data() + cell.size(), value);
+    return result.ec == std::errc() && result.ptr != cell.data() &&
+           std::all_of(result.ptr, cell.data() + cell.size(), [](char c) { return c == '*'; });
+}
+
+std::optional<size_t> find_column(const std::vector<ColumnSpan>& columns, std::string_view name) {
+    for (size_t c = 0; c < columns.size(); ++c) {
+        if (columns[c].name == name) {
+            return c;
+        }
+    }
+    return std::nullopt;
+}
+
+// Column names may hold digits and letters only, so the first operator
+// character that splits the text into two known columns is the operator.
+std::optional<Expression> compile(std::string_view text, const std::vector<ColumnSpan>& columns) {
+    if (std::optional<size_t> column = find_column(columns, text)) {
+        return Expression{*column, 0, 0};
+    }
+    for (size_t i = 1; i + 1 < text.size(); ++i) {
+        if (std::strchr("+-*/", text[i])) {
+            std::optional<size_t> left = find_column(columns, text.substr(0, i));
+            std::optional<size_t> right = find_column(columns, text.substr(i + 1));
+            if (left && right) {
+                return Expression{*left, text[i], *right};
+            }
+        }
+    }
+    return std::nullopt;
+}
+
+std::vector<std::string_view> sample_rows(std::string_view rows) {
+    std::vector<std::string_view> sample;
+    while (!rows.empty() && sample.size() < SAMPLE_ROWS) {
+        size_t newline = rows.find('\n');
+        std::string_view line = rows.substr(0, newline);
+        if (is_data_row(line)) {
+            sample.push_back(line);
+        }
+        rows.remove_prefix(newline == std::string_view::npos ? rows.size() : newline + 1);
+    }
+    return sample;
+}
+
+// Adds value to the k largest, where an equal value does not displace an
+// earlier row.
+void keep_top(std::vector<AggregateValue>& kept, size_t k, double value, std::string_view row,
+              const ColumnSpan& label) {
+    if (k == 0 || (kept.size() == k && value <= kept.back().value)) {
+        return;
+    }
+    auto position = std::upper_bound(kept.begin(), kept.end(), value,
+                                     [](double v, const AggregateValue& other) { return v > other.value; });
+    kept.insert(position, {value, std::string(column_cell(row, label))});
+    if (kept.size() > k) {
+        kept.pop_back();
+    }
+}
+
+} // namespace
+
+std::optional<AggregateSpec> parse_aggregate(std::string_view text) {
+    size_t colon = text.find(':');
+    if (colon == std::string_view::npos || colon + 1 == text.size()) {
+        return std::nullopt;
+    }
+    AggregateSpec spec;
+    spec.text = text;
+    spec.expression = text.substr(colon + 1);
+    std::string_view kind = text.substr(0, colon);
+    const char* end = kind.data() + kind.size();
+    if (kind == "min") {
+        spec.kind = AggregateKind::Min;
+    } else if (kind == "max") {
+        spec.kind = AggregateKind::Max;
+    } else if (kind == "avg") {
+        spec.kind = AggregateKind::Avg;
+    } else if (kind.rfind("top", 0) == 0) {
+        spec.kind = AggregateKind::TopK;
+        auto result = std::from_chars(kind.data() + 3, end, spec.k);
+        if (result.ec != std::errc() || result.ptr != end || spec.k == 0) {
+            return std::nullopt;
+        }
+    } else if (kind.rfind("p", 0) == 0) {
+        spec.kind = AggregateKind::Quantile;
+        double percent;
+        auto result = std::from_chars(kind.data() + 1, end, percent);
+        if (result.ec != std::errc() || result.ptr != end || !(percent >= 0 && percent <= 100)) {
+            return std::nullopt;
+        }
+        spec.quantile = percent / 100;
+    } else {
+        return std::nullopt;
+    }
+    return spec;
+}
+
+std::vector<AggregateResult> run_aggregates(std::string_view text, const std::vector<AggregateSpec>& specs) {
+    std::vector<AggregateResult> results(specs.size());
+    size_t newline = text.find('\n');
+    if (newline == std::string_view::npos) {
+        return results;
+    }
+    std::string_view rows = text.substr(newline + 1);
+    std::vector<std::string_view> sample = sample_rows(rows);
+    std::vector<ColumnSpan> columns = find_columns(text.substr(0, newline), sample);
+    if (columns.empty()) {
+        return results;
+    }
+
+    // When the rows are labelled by number (Dy), a row labelled by a word is
+    // a summary such as "mo", whose values must not win a min, max or top-k.
+    size_t intLabels = std::count_if(sample.begin(), sample.end(),
+                                     [&](std::string_view row) { return is_int(column_cell(row, columns[0])); });
+    bool intLabelsOnly = intLabels * 2 > sample.size();
+
+    // Only the columns some aggregate reads are parsed.
+    std::vector<State> states(specs.size());
+    std::vector<size_t> used;
+    for (size_t i = 0; i < specs.size(); ++i) {
+        std::optional<Expression> expression = compile(specs[i].expression, columns);
+        results[i].ok = expression.has_value();
+        results[i].labelColumn = columns[0].name;
+        if (expression) {
+            states[i].expression = *expression;
+            used.push_back(expression->left);
+            used.push_back(expression->op ? expression->right : expression->left);
+        }
+    }
+    std::sort(used.begin(), used.end());
+    used.erase(std::unique(used.begin(), used.end()), used.end());
+
+    std::vector<double> values(columns.size());
+    std::vector<uint8_t> present(columns.size());
+    const char* p = rows.data();
+    const char* end = p + rows.size();
+    while (p != end) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        lineEnd = lineEnd ? lineEnd : end;
+        std::string_view row(p, lineEnd - p);
+        p = lineEnd == end ? end : lineEnd + 1;
+        if (!is_data_row(row) || (intLabelsOnly && !is_int(column_cell(row, columns[0])))) {
+            continue;
+        }
+
+        for (size_t c : used) {
+            present[c] = parse_number(column_cell(row, columns[c]), values[c]);
+        }
+        for (size_t i = 0; i < specs.size(); ++i) {
+            if (!results[i].ok) {
+                continue;
+            }
+            State& state = states[i];
+            const Expression& e = state.expression;
+            if (!present[e.left] || (e.op && !present[e.right])) {
+                continue;
+            }
+            double value = values[e.left];
+            switch (e.op) {
+            case '+':
+                value += values[e.right];
+                break;
+            case '-':
+                value -= values[e.right];
+                break;
+            case '*':
+                value *= values[e.right];
+                break;
+            case '/':
+                value /= values[e.right];
+                break;
+            }
+
+            size_t seen = results[i].rows++;
+            switch (specs[i].kind) {
+            case AggregateKind::Min:
+                if (seen == 0 || value < state.kept[0].value) {
+                    state.kept.assign(1, {value, std::string(column_cell(row, columns[0]))});
+                }
+                break;
+            case AggregateKind::Max:
+                if (seen == 0 || value > state.kept[0].value) {
+                    state.kept.assign(1, {value, std::string(column_cell(row, columns[0]))});
+                }
+                break;
+            case AggregateKind::Avg:
+                state.sum += value;
+                break;
+            case AggregateKind::TopK:
+                keep_top(state.kept, specs[i].k, value, row, columns[0]);
+                break;
+            case AggregateKind::Quantile:
+                // Reservoir sampling: every row seen so far is kept with the
+                // same probability.
+                if (state.samples.size() < RESERVOIR) {
+                    state.samples.push_back(value);
+                } else if (size_t slot = state.rng() % (seen + 1); slot < RESERVOIR) {
+                    state.samples[slot] = value;
+                }
+                break;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < specs.size(); ++i) {
+        AggregateResult& result = results[i];
+        State& state = states[i];
+        if (result.rows == 0) {
+            continue;
+        }
+        if (specs[i].kind == AggregateKind::Avg) {
+            result.values.push_back({state.sum / static_cast<double>(result.rows), {}});
+        } else if (specs[i].kind == AggregateKind::Quantile) {
+            // The sample at rank quantile * (n - 1), rounded
+            std::vector<double>& samples = state.samples;
+            size_t rank = static_cast<size_t>(specs[i].quantile * static_cast<double>(samples.size() - 1) + 0.5);
+            std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+            result.values.push_back({samples[rank], {}});
+        } else {
+            result.values = std::move(state.kept);
+        }
+    }
+    return results;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+enum class AggregateKind { Min, Max, Avg, TopK, Quantile };
+
+// One aggregate over a derived column: a column of the file, or two columns
+// joined by +, -, * or /, such as "MxT-MnT".
+struct AggregateSpec {
+    std::string text;
+    AggregateKind kind = AggregateKind::Min;
+    std::string expression;
+    // Rows kept by TopK
+    size_t k = 0;
+    // Fraction for Quantile, in [0, 1]
+    double quantile = 0;
+};
+
+// Reads "min:EXPR", "max:EXPR", "avg:EXPR", "top<k>:EXPR" or
+// "p<percent>:EXPR". Empty if malformed.
+std::optional<AggregateSpec> parse_aggregate(std::string_view text);
+
+struct AggregateValue {
+    double value = 0;
+    // The first column of the row the value came from, empty for avg and
+    // quantiles.
+    std::string label;
+};
+
+struct AggregateResult {
+    // False if the expression names a column the file does not have.
+    bool ok = false;
+    // Name of the first column, which labels the rows in values
+    std::string labelColumn;
+    // Rows where the expression had a value
+    size_t rows = 0;
+    // One value, or up to k for TopK, largest first; none if rows is 0.
+    std::vector<AggregateValue> values;
+};
+
+// Evaluates every aggregate in one scan over the rows of a .dat file, each
+// column a row uses parsed once. Memory does not grow with the file: top-k
+// keeps k rows and a quantile a fixed reservoir of samples, exact until it
+// has seen more rows than it holds. Separators are skipped, and so are
+// summary rows: where the rows are numbered, a row labelled by a word.
+std::vector<AggregateResult> run_aggregates(std::string_view text, const std::vector<AggregateSpec>& specs);
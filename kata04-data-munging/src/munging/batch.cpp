@@ -0,0 +1,376 @@
+#include "batch.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "weather.h"
+
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#define HAVE_IO_URING 1
+#endif
+
+namespace {
+
+// Reads the whole file with blocking reads.
+bool read_file(const std::string& path, std::vector<char>& data) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    bool ok = fstat(fd, &st) == 0;
+    data.resize(ok ? static_cast<size_t>(st.st_size) : 0);
+    size_t done = 0;
+    while (ok && done < data.size()) {
+        ssize_t bytes = read(fd, data.data() + done, data.size() - done);
+        if (bytes < 0 && errno == EINTR) {
+            continue;
+        }
+        ok = bytes >= 0;
+        // A file that shrank since fstat ends early.
+        if (bytes <= 0) {
+            data.resize(done);
+            break;
+        }
+        done += static_cast<size_t>(bytes);
+    }
+    close(fd);
+    return ok;
+}
+
+void min_spread_threads(std::vector<FileResult>& files, unsigned threads) {
+    std::atomic<size_t> next{0};
+    auto work = [&] {
+        std::vector<char> data;
+        for (size_t i = next++; i < files.size(); i = next++) {
+            files[i].ok = read_file(files[i].path, data);
+            if (files[i].ok) {
+                files[i].result = min_spread_text({data.data(), data.size()});
+            }
+        }
+    };
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < std::min<size_t>(std::max(threads, 1u), files.size()); ++t) {
+        pool.emplace_back(work);
+    }
+    work();
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+}
+
+#ifdef HAVE_IO_URING
+// The parts of io_uring that batch reads need, through the raw system calls
+// so that liburing is not required.
+class Ring {
+public:
+    explicit Ring(unsigned entries) {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        fd_ = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (fd_ < 0) {
+            return;
+        }
+
+        sqSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqSize_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (single) {
+            sqSize_ = cqSize_ = std::max(sqSize_, cqSize_);
+        }
+        sq_ = map(sqSize_, IORING_OFF_SQ_RING);
+        cq_ = single ? sq_ : map(cqSize_, IORING_OFF_CQ_RING);
+        sqesSize_ = params.sq_entries * sizeof(io_uring_sqe);
+        sqes_ = static_cast<io_uring_sqe*>(map(sqesSize_, IORING_OFF_SQES));
+        if (!sq_ || !cq_ || !sqes_) {
+            return;
+        }
+
+        char* sq = static_cast<char*>(sq_);
+        sqTail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sqMask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sqArray_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        char* cq = static_cast<char*>(cq_);
+        cqHead_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cqTail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cqMask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        // Kernels 5.1 to 5.5 set up a ring but fail every IORING_OP_READ.
+        ok_ = supports(IORING_OP_READ);
+    }
+
+    ~Ring() {
+        if (sqes_) {
+            munmap(sqes_, sqesSize_);
+        }
+        if (cq_ && cq_ != sq_) {
+            munmap(cq_, cqSize_);
+        }
+        if (sq_) {
+            munmap(sq_, sqSize_);
+        }
+        if (fd_ >= 0) {
+            close(fd_);
+        }
+    }
+
+    Ring(const Ring&) = delete;
+    Ring& operator=(const Ring&) = delete;
+
+    bool ok() const { return ok_; }
+
+    // Queues a read; the caller keeps no more reads in flight than entries.
+    void read(int fd, char* buffer, size_t size, uint64_t offset, uint64_t userData) {
+        unsigned tail = *sqTail_;
+        unsigned index = tail & sqMask_;
+        io_uring_sqe* sqe = &sqes_[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = IORING_OP_READ;
+        sqe->fd = fd;
+        sqe->addr = reinterpret_cast<uint64_t>(buffer);
+        sqe->len = static_cast<unsigned>(std::min<size_t>(size, 1u << 30));
+        sqe->off = offset;
+        sqe->user_data = userData;
+        sqArray_[index] = index;
+        __atomic_store_n(sqTail_, tail + 1, __ATOMIC_RELEASE);
+        ++queued_;
+    }
+
+    // Submits the queued reads and waits for at least one completion.
+    bool submit_and_wait() {
+        return enter(queued_);
+    }
+
+    // Waits for at least one completion of the reads already submitted.
+    bool wait() {
+        return enter(0);
+    }
+
+    // Reads queued but not yet submitted, which the kernel has not seen.
+    unsigned queued() const { return queued_; }
+
+    bool pop(uint64_t& userData, int& result) {
+        unsigned head = *cqHead_;
+        if (head == __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE)) {
+            return false;
+        }
+        const io_uring_cqe& cqe = cqes_[head & cqMask_];
+        userData = cqe.user_data;
+        result = cqe.res;
+        __atomic_store_n(cqHead_, head + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+
+private:
+    // Asks the kernel whether it implements op. Kernels without the probe
+    // (before 5.6) have no IORING_OP_READ either.
+    bool supports(unsigned op) const {
+        const unsigned ops = 256;
+        std::vector<uint64_t> buffer((sizeof(io_uring_probe) + ops * sizeof(io_uring_probe_op)) / sizeof(uint64_t) + 1);
+        io_uring_probe* probe = reinterpret_cast<io_uring_probe*>(buffer.data());
+        if (syscall(__NR_io_uring_register, fd_, IORING_REGISTER_PROBE, probe, ops) < 0) {
+            return false;
+        }
+        return op < probe->ops_len && (probe->ops[op].flags & IO_URING_OP_SUPPORTED);
+    }
+
+    bool enter(unsigned toSubmit) {
+        for (;;) {
+            long submitted = syscall(__NR_io_uring_enter, fd_, toSubmit, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+            if (submitted >= 0) {
+                queued_ -= static_cast<unsigned>(submitted);
+                return true;
+            }
+            if (errno != EINTR) {
+                return false;
+            }
+        }
+    }
+
+    void* map(size_t size, off_t offset) {
+        void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, offset);
+        return p == MAP_FAILED ? nullptr : p;
+    }
+
+    int fd_ = -1;
+    bool ok_ = false;
+    void* sq_ = nullptr;
+    void* cq_ = nullptr;
+    io_uring_sqe* sqes_ = nullptr;
+    size_t sqSize_ = 0;
+    size_t cqSize_ = 0;
+    size_t sqesSize_ = 0;
+    unsigned* sqTail_ = nullptr;
+    unsigned* sqArray_ = nullptr;
+    unsigned sqMask_ = 0;
+    unsigned* cqHead_ = nullptr;
+    unsigned* cqTail_ = nullptr;
+    io_uring_cqe* cqes_ = nullptr;
+    unsigned cqMask_ = 0;
+    unsigned queued_ = 0;
+};
+
+// A file being read: its buffer is reused by the next file in the slot.
+struct Slot {
+    int fd = -1;
+    size_t file = 0;
+    size_t done = 0;
+    std::vector<char> data;
+};
+
+// Waits for the reads the kernel was given, which may still write into the
+// slot buffers. If even waiting fails the buffers are leaked, never freed
+// under a read.
+void drain(Ring& ring, std::vector<Slot>& slots, size_t submitted) {
+    uint64_t index;
+    int result;
+    while (submitted > 0) {
+        while (submitted > 0 && ring.pop(index, result)) {
+            --submitted;
+        }
+        if (submitted > 0 && !ring.wait()) {
+            new std::vector<Slot>(std::move(slots));
+            return;
+        }
+    }
+}
+
+// Returns false if io_uring cannot be used, with every file reset to not
+// read.
+bool min_spread_uring(std::vector<FileResult>& files, unsigned depth) {
+    depth = std::max(depth, 1u);
+    Ring ring(depth);
+    if (!ring.ok()) {
+        return false;
+    }
+
+    std::vector<Slot> slots(depth);
+    std::vector<size_t> idle;
+    for (size_t s = depth; s > 0; --s) {
+        idle.push_back(s - 1);
+    }
+
+    auto finish = [&](Slot& slot, bool ok) {
+        close(slot.fd);
+        slot.fd = -1;
+        FileResult& file = files[slot.file];
+        file.ok = ok;
+        if (ok) {
+            file.result = min_spread_text({slot.data.data(), slot.done});
+        }
+    };
+
+    size_t next = 0;
+    size_t inFlight = 0;
+    while (next < files.size() || inFlight > 0) {
+        // Start reads until every slot is busy.
+        while (next < files.size() && !idle.empty()) {
+            size_t file = next++;
+            int fd = open(files[file].path.c_str(), O_RDONLY);
+            struct stat st;
+            if (fd < 0 || fstat(fd, &st) != 0) {
+                if (fd >= 0) {
+                    close(fd);
+                }
+                continue;
+            }
+            Slot& slot = slots[idle.back()];
+            slot.fd = fd;
+            slot.file = file;
+            slot.done = 0;
+            slot.data.resize(static_cast<size_t>(st.st_size));
+            if (slot.data.empty()) {
+                finish(slot, true);
+                continue;
+            }
+            ring.read(fd, slot.data.data(), slot.data.size(), 0, idle.back());
+            idle.pop_back();
+            ++inFlight;
+        }
+        if (inFlight == 0) {
+            continue;
+        }
+
+        if (!ring.submit_and_wait()) {
+            for (Slot& slot : slots) {
+                if (slot.fd >= 0) {
+                    close(slot.fd);
+                }
+            }
+            drain(ring, slots, inFlight - ring.queued());
+            for (FileResult& file : files) {
+                file.ok = false;
+                file.result = MinSpread();
+            }
+            return false;
+        }
+        // Parse what has arrived; the kernel keeps reading the other slots.
+        uint64_t index;
+        int result;
+        while (ring.pop(index, result)) {
+            Slot& slot = slots[index];
+            if (result > 0) {
+                slot.done += static_cast<size_t>(result);
+            }
+            if (result > 0 && slot.done < slot.data.size()) {
+                ring.read(slot.fd, slot.data.data() + slot.done, slot.data.size() - slot.done, slot.done, index);
+                continue;
+            }
+            // A read of 0 bytes means the file shrank since fstat.
+            finish(slot, result >= 0);
+            idle.push_back(index);
+            --inFlight;
+        }
+    }
+    return true;
+}
+#endif
+
+} // namespace
+
+std::vector<FileResult> min_spread_files(const std::vector<std::string>& paths, const BatchOptions& options) {
+    std::vector<FileResult> files(paths.size());
+    for (size_t i = 0; i < paths.size(); ++i) {
+        files[i].path = paths[i];
+    }
+#ifdef HAVE_IO_URING
+    if (options.io == BatchIo::Uring && min_spread_uring(files, options.depth)) {
+        return files;
+    }
+#endif
+    min_spread_threads(files, options.threads);
+    return files;
+}
+
+std::optional<size_t> min_spread_best(const std::vector<FileResult>& files) {
+    std::optional<size_t> best;
+    MinSpread smallest;
+    for (size_t i = 0; i < files.size(); ++i) {
+        if (files[i].ok && files[i].result.spread < smallest.spread) {
+            smallest = files[i].result;
+            best = i;
+        }
+    }
+    return best;
+}
+
+std::vector<std::string> list_directory(const std::string& path) {
+    std::vector<std::string> paths;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(path, error)) {
+        if (entry.is_regular_file(error)) {
+            paths.push_back(entry.path().string());
+        }
+    }
+    std::sort(paths.begin(), paths.end());
+    return paths;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <algorithm>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "min_spread.h"
+
+enum class BatchIo {
+    // io_uring, falling back to Threads where the kernel does not offer it
+    Uring,
+    Threads,
+};
+
+struct BatchOptions {
+    BatchIo io = BatchIo::Uring;
+    // Reads kept in flight by io_uring
+    unsigned depth = 32;
+    // Workers that each read and parse whole files
+    unsigned threads = std::max(std::thread::hardware_concurrency(), 1u);
+};
+
+struct FileResult {
+    std::string path;
+    MinSpread result;
+    bool ok = false;
+};
+
+// The weather answer for each of paths, in the same order. With io_uring the
+// reads of the next files are in flight while the current one is parsed.
+std::vector<FileResult> min_spread_files(const std::vector<std::string>& paths, const BatchOptions& options = {});
+
+// The file holding the smallest spread of all, the earliest one on ties.
+std::optional<size_t> min_spread_best(const std::vector<FileResult>& files);
+
+// Regular files directly in a directory, sorted by name.
+std::vector<std::string> list_directory(const std::string& path);
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+// A fixed ring of reusable buffers handed from one producer thread to one
+// consumer thread. The two sides only share the head and tail counters, so
+// neither takes a lock; a side with nothing to do yields until the other
+// catches up. The consumer must drain the ring, or the producer waits for
+// it forever.
+class BufferRing {
+public:
+    struct Buffer {
+        std::vector<char> data;
+        size_t size = 0;
+    };
+
+    BufferRing(size_t buffers, size_t bufferBytes) : buffers_(buffers) {
+        for (Buffer& buffer : buffers_) {
+            buffer.data.resize(bufferBytes);
+        }
+    }
+
+    // Producer: the next buffer to fill.
+    Buffer& acquire() {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        while (tail - head_.load(std::memory_order_acquire) == buffers_.size()) {
+            std::this_thread::yield();
+        }
+        return buffers_[tail % buffers_.size()];
+    }
+
+    // Producer: hands the buffer from acquire to the consumer.
+    void publish() { tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+    // Producer: no more buffers will be published.
+    void close() { closed_.store(true, std::memory_order_release); }
+
+    // Consumer: the next filled buffer, or nullptr once the ring is closed
+    // and drained.
+    Buffer* next() {
+        size_t head = head_.load(std::memory_order_relaxed);
+        for (;;) {
+            // Read closed first: buffers published before close are then
+            // visible below.
+            bool closed = closed_.load(std::memory_order_acquire);
+            if (head != tail_.load(std::memory_order_acquire)) {
+                return &buffers_[head % buffers_.size()];
+            }
+            if (closed) {
+                return nullptr;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    // Consumer: returns the buffer from next to the producer.
+    void release() { head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+private:
+    std::vector<Buffer> buffers_;
+    // Counters only grow; a buffer's slot is the counter modulo the size.
+    alignas(64) std::atomic<size_t> head_{0};
+    alignas(64) std::atomic<size_t> tail_{0};
+    std::atomic<bool> closed_{false};
+};
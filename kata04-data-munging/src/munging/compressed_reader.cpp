@@ -0,0 +1,81 @@
+#include "compressed_reader.h"
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include <zlib.h>
+
+#include "buffer_ring.h"
+#include "row_parser.h"
+
+std::optional<MinSpread> min_spread_gzip(const std::string& path, const DecompressOptions& options) {
+    gzFile file = gzopen(path.c_str(), "rb");
+    if (!file) {
+        return std::nullopt;
+    }
+    gzbuffer(file, 256 * 1024);
+
+    BufferRing ring(std::max<size_t>(options.buffers, 2), std::max<size_t>(options.bufferBytes, 1));
+    bool failed = false;
+    std::thread inflater([&] {
+        for (;;) {
+            BufferRing::Buffer& buffer = ring.acquire();
+            int bytes = gzread(file, buffer.data.data(), static_cast<unsigned>(buffer.data.size()));
+            if (bytes <= 0) {
+                // A truncated stream ends with an error rather than with -1.
+                int error = Z_OK;
+                gzerror(file, &error);
+                failed = bytes < 0 || (error != Z_OK && error != Z_STREAM_END);
+                break;
+            }
+            buffer.size = static_cast<size_t>(bytes);
+            ring.publish();
+        }
+        ring.close();
+    });
+
+    MinSpread result;
+    bool header = true;
+    // The start of a line that continues in the next buffer
+    std::string carry;
+    auto line = [&](const char* begin, const char* end) {
+        if (header) {
+            header = false;
+            return;
+        }
+        int day, maxTemp, minTemp;
+        if (parse_row(begin, end, day, maxTemp, minTemp)) {
+            result.add(day, maxTemp, minTemp);
+        }
+    };
+
+    while (BufferRing::Buffer* buffer = ring.next()) {
+        const char* p = buffer->data.data();
+        const char* end = p + buffer->size;
+        const char* newline = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        if (!carry.empty() && newline) {
+            carry.append(p, newline);
+            line(carry.data(), carry.data() + carry.size());
+            carry.clear();
+            p = newline + 1;
+            newline = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        }
+        while (newline) {
+            line(p, newline);
+            p = newline + 1;
+            newline = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        }
+        carry.append(p, end);
+        ring.release();
+    }
+    if (!carry.empty()) {
+        line(carry.data(), carry.data() + carry.size());
+    }
+
+    inflater.join();
+    gzclose(file);
+    if (failed) {
+        return std::nullopt;
+    }
+    return result;
+}
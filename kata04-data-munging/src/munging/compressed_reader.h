@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+
+#include "min_spread.h"
+
+struct DecompressOptions {
+    // Decompressed bytes per buffer of the ring
+    size_t bufferBytes = 1 << 20;
+    // Buffers in the ring; decompression runs up to this far ahead
+    size_t buffers = 8;
+};
+
+// The weather answer for a gzip-compressed file (plain text is read as is),
+// without writing the decompressed text anywhere: one thread inflates into a
+// BufferRing while the calling thread parses the buffers it fills. Empty if
+// the file cannot be opened or is corrupt.
+std::optional<MinSpread> min_spread_gzip(const std::string& path, const DecompressOptions& options = {});
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Read-only memory mapping of a whole file, walked in place by the parsers.
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool is_open() const { return open_; }
+    std::string_view data() const { return {data_, size_}; }
+    // Modification time in nanoseconds, from the same fstat that sized the
+    // mapping.
+    int64_t mtime() const { return mtime_; }
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    int64_t mtime_ = 0;
+    bool open_ = false;
+};
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <limits>
+
+// Running minimum of maxTemp - minTemp. The first day with the smallest
+// spread wins, as in the original part1 loop.
+struct MinSpread {
+    int day = 0;
+    int spread = std::numeric_limits<int>::max();
+
+    void add(int rowDay, int maxTemp, int minTemp) {
+        int rowSpread = maxTemp - minTemp;
+        if (rowSpread < spread) {
+            spread = rowSpread;
+            day = rowDay;
+        }
+    }
+};
@@ -0,0 +1,73 @@
+#include "weather.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+// Chunks per thread, so a slow chunk does not leave the other threads idle
+// at the end.
+static const size_t CHUNKS_PER_THREAD = 8;
+// Below this a chunk costs more to hand out than to parse.
+static const size_t MIN_CHUNK_BYTES = 1 << 20;
+
+// Splits rows into about count pieces, each ending just after a newline
+// (the last one at the end of the rows).
+static std::vector<std::string_view> split_rows(std::string_view rows, size_t count) {
+    std::vector<std::string_view> chunks;
+    size_t target = std::max(rows.size() / std::max<size_t>(count, 1), MIN_CHUNK_BYTES);
+    const char* begin = rows.data();
+    const char* end = begin + rows.size();
+    while (begin != end) {
+        const char* cut = end;
+        if (static_cast<size_t>(end - begin) > target) {
+            const char* newline = static_cast<const char*>(std::memchr(begin + target, '\n', end - begin - target));
+            if (newline) {
+                cut = newline + 1;
+            }
+        }
+        chunks.emplace_back(begin, cut - begin);
+        begin = cut;
+    }
+    return chunks;
+}
+
+MinSpread min_spread_parallel(std::string_view text, unsigned threads) {
+    // Skip the header line
+    const char* newline = static_cast<const char*>(std::memchr(text.data(), '\n', text.size()));
+    if (!newline) {
+        return MinSpread();
+    }
+    std::string_view rows = text.substr(newline + 1 - text.data());
+
+    threads = std::max(threads, 1u);
+    std::vector<std::string_view> chunks = split_rows(rows, threads * CHUNKS_PER_THREAD);
+    std::vector<MinSpread> partial(chunks.size());
+
+    // Workers take the next chunk until none are left.
+    std::atomic<size_t> next{0};
+    auto work = [&] {
+        for (size_t i = next++; i < chunks.size(); i = next++) {
+            partial[i] = min_spread_rows(chunks[i]);
+        }
+    };
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < std::min<size_t>(threads, chunks.size()); ++t) {
+        pool.emplace_back(work);
+    }
+    work();
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+
+    // A later chunk only wins with a strictly smaller spread, the same rule
+    // as rows within a chunk.
+    MinSpread result;
+    for (const MinSpread& chunk : partial) {
+        if (chunk.spread < result.spread) {
+            result = chunk;
+        }
+    }
+    return result;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <charconv>
+
+// The whitespace `iss >>` skips in the C locale.
+constexpr bool is_space(char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+// Allocation-free equivalent of `iss >> value` for an int: skips leading
+// whitespace, accepts an optional sign and stops right after the digits,
+// so "97*" yields 97 and leaves "*" for the next field, which then fails
+// just as it does for the stream. Fails on overflow like the stream too.
+inline bool parse_int(const char*& p, const char* end, int& value) {
+    while (p != end && is_space(*p)) {
+        ++p;
+    }
+    const char* first = p;
+    if (first != end && *first == '+') {
+        ++first;
+        if (first != end && *first == '-') {
+            return false;
+        }
+    }
+    auto result = std::from_chars(first, end, value);
+    if (result.ec != std::errc()) {
+        return false;
+    }
+    p = result.ptr;
+    return true;
+}
+
+// Reads the day, max and min temperature columns of one line, accepting
+// exactly the lines `iss >> day >> maxTemp >> minTemp` accepts.
+inline bool parse_row(const char* p, const char* end, int& day, int& maxTemp, int& minTemp) {
+    return parse_int(p, end, day) && parse_int(p, end, maxTemp) && parse_int(p, end, minTemp);
+}
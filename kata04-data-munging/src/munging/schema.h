@@ -0,0 +1,197 @@
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+#include <tuple>
+#include <utility>
+
+#include "row_parser.h"
+
+// Row parsers specialized at compile time for a schema. A schema is a type
+// with the header line of its files,
+//
+//     struct WeatherSchema {
+//         static constexpr std::string_view header = "Dy MxT MnT ...";
+//     };
+//
+// and a field is a type naming one of its columns and the type to read,
+//
+//     struct MxT {
+//         static constexpr std::string_view name = "MxT";
+//         using type = int;
+//     };
+//
+// RowParser<WeatherSchema, Dy, MxT> looks the names up in the header while
+// compiling and becomes straight-line code for those columns: columns in
+// between are stepped over without parsing and nothing after the last
+// field is read. Columns are whitespace separated, so a field must not come
+// after a column that can be blank.
+namespace schema {
+
+constexpr size_t npos = static_cast<size_t>(-1);
+
+// Position of name among the names in header, npos if it is not there.
+constexpr size_t column_index(std::string_view header, std::string_view name) {
+    size_t index = 0;
+    size_t i = 0;
+    for (;;) {
+        while (i < header.size() && is_space(header[i])) {
+            ++i;
+        }
+        if (i == header.size()) {
+            return npos;
+        }
+        size_t begin = i;
+        while (i < header.size() && !is_space(header[i])) {
+            ++i;
+        }
+        if (header.substr(begin, i - begin) == name) {
+            return index;
+        }
+        ++index;
+    }
+}
+
+constexpr size_t column_count(std::string_view header) {
+    size_t count = 0;
+    for (size_t i = 0; i < header.size(); ++i) {
+        count += !is_space(header[i]) && (i == 0 || is_space(header[i - 1]));
+    }
+    return count;
+}
+
+// Numbers may carry the trailing '*' flag these files use, as in "97*", and
+// must then end at whitespace.
+template <typename Number>
+bool parse_number(const char*& p, const char* end, Number& value) {
+    auto result = std::from_chars(p, end, value);
+    if (result.ec != std::errc()) {
+        return false;
+    }
+    p = result.ptr;
+    while (p != end && *p == '*') {
+        ++p;
+    }
+    return p == end || is_space(*p);
+}
+
+inline bool parse_field(const char*& p, const char* end, int& value) {
+    return parse_number(p, end, value);
+}
+
+inline bool parse_field(const char*& p, const char* end, double& value) {
+    return parse_number(p, end, value);
+}
+
+inline bool parse_field(const char*& p, const char* end, std::string_view& value) {
+    const char* begin = p;
+    while (p != end && !is_space(*p)) {
+        ++p;
+    }
+    value = std::string_view(begin, p - begin);
+    return true;
+}
+
+// True if line has exactly the column names of Schema.
+template <typename Schema>
+bool header_matches(std::string_view line) {
+    size_t count = 0;
+    for (size_t i = 0; i < line.size();) {
+        if (is_space(line[i])) {
+            ++i;
+            continue;
+        }
+        size_t begin = i;
+        while (i < line.size() && !is_space(line[i])) {
+            ++i;
+        }
+        if (column_index(Schema::header, line.substr(begin, i - begin)) != count++) {
+            return false;
+        }
+    }
+    return count == column_count(Schema::header);
+}
+
+template <typename Schema, typename... Fields>
+class RowParser {
+    static constexpr size_t indices[] = {column_index(Schema::header, Fields::name)...};
+    static_assert(((column_index(Schema::header, Fields::name) != npos) && ...),
+                  "every field must be a column of the schema");
+
+    static constexpr size_t last() {
+        size_t last = 0;
+        for (size_t index : indices) {
+            last = index > last ? index : last;
+        }
+        return last;
+    }
+
+    // The field read from the column at position, npos for columns skipped
+    static constexpr size_t field_at(size_t position) {
+        for (size_t field = 0; field < sizeof...(Fields); ++field) {
+            if (indices[field] == position) {
+                return field;
+            }
+        }
+        return npos;
+    }
+
+public:
+    using Row = std::tuple<typename Fields::type...>;
+
+    // Reads the fields from the line [p, end). False if a column is missing
+    // or a field does not parse as its type.
+    static bool parse(const char* p, const char* end, Row& row) {
+        return parse_columns(p, end, row, std::make_index_sequence<last() + 1>());
+    }
+
+private:
+    template <size_t... Positions>
+    static bool parse_columns(const char*& p, const char* end, Row& row, std::index_sequence<Positions...>) {
+        return (parse_column<Positions>(p, end, row) && ...);
+    }
+
+    template <size_t Position>
+    static bool parse_column(const char*& p, const char* end, Row& row) {
+        while (p != end && is_space(*p)) {
+            ++p;
+        }
+        if (p == end) {
+            return false;
+        }
+        constexpr size_t field = field_at(Position);
+        if constexpr (field == npos) {
+            while (p != end && !is_space(*p)) {
+                ++p;
+            }
+            return true;
+        } else {
+            return parse_field(p, end, std::get<field>(row));
+        }
+    }
+};
+
+// Passes every row under the header of text that Parser accepts to visit.
+template <typename Parser, typename Visit>
+void for_each_row(std::string_view text, Visit visit) {
+    const char* p = text.data();
+    const char* end = p + text.size();
+
+    // Skip the header line
+    const char* newline = static_cast<const char*>(std::memchr(p, '\n', end - p));
+    p = newline ? newline + 1 : end;
+
+    typename Parser::Row row;
+    while (p != end) {
+        newline = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        const char* lineEnd = newline ? newline : end;
+        if (Parser::parse(p, lineEnd, row)) {
+            visit(row);
+        }
+        p = newline ? newline + 1 : end;
+    }
+}
+
+} // namespace schema
@@ -0,0 +1,70 @@
+#include "simd_scanner.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include "row_parser.h"
+
+static BlockMasks classify_scalar(const char* p) {
+    BlockMasks masks = {0, 0};
+    for (unsigned i = 0; i < 64; ++i) {
+        masks.newlines |= static_cast<uint64_t>(p[i] == '\n') << i;
+        masks.spaces |= static_cast<uint64_t>(is_space(p[i])) << i;
+    }
+    return masks;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+__attribute__((target("sse2")))
+static BlockMasks classify_sse2(const char* p) {
+    BlockMasks masks = {0, 0};
+    for (unsigned i = 0; i < 64; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+        // '\t' .. '\r' are contiguous: v - '\t' <= 4 as unsigned bytes.
+        __m128i shifted = _mm_sub_epi8(v, _mm_set1_epi8('\t'));
+        __m128i control = _mm_cmpeq_epi8(_mm_min_epu8(shifted, _mm_set1_epi8(4)), shifted);
+        __m128i space = _mm_or_si128(control, _mm_cmpeq_epi8(v, _mm_set1_epi8(' ')));
+        __m128i newline = _mm_cmpeq_epi8(v, _mm_set1_epi8('\n'));
+        masks.newlines |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(newline))) << i;
+        masks.spaces |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(space))) << i;
+    }
+    return masks;
+}
+
+__attribute__((target("avx2")))
+static BlockMasks classify_avx2(const char* p) {
+    BlockMasks masks = {0, 0};
+    for (unsigned i = 0; i < 64; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+        __m256i shifted = _mm256_sub_epi8(v, _mm256_set1_epi8('\t'));
+        __m256i control = _mm256_cmpeq_epi8(_mm256_min_epu8(shifted, _mm256_set1_epi8(4)), shifted);
+        __m256i space = _mm256_or_si256(control, _mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')));
+        __m256i newline = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n'));
+        masks.newlines |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(newline))) << i;
+        masks.spaces |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(space))) << i;
+    }
+    return masks;
+}
+#endif
+
+using Classifier = BlockMasks (*)(const char*);
+
+static Classifier select_classifier() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return classify_avx2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return classify_sse2;
+    }
+#endif
+    return classify_scalar;
+}
+
+static const Classifier classifier = select_classifier();
+
+BlockMasks classify_block(const char* p) {
+    return classifier(p);
+}
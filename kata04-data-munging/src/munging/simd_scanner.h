@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstdint>
+
+// Bit i of each mask describes byte i of a 64-byte block.
+struct BlockMasks {
+    uint64_t newlines;
+    uint64_t spaces;  // every byte `iss >> int` skips, newlines included
+};
+
+// Classifies 64 bytes at p with AVX2 or SSE2 when the CPU has them (picked
+// once at startup), otherwise byte by byte.
+BlockMasks classify_block(const char* p);
@@ -0,0 +1,96 @@
+#include "stream_reader.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <unistd.h>
+#include <vector>
+
+#include "row_parser.h"
+
+std::optional<MinSpread> min_spread_fd(int fd, const StreamOptions& options, const StreamReport& report) {
+    using Clock = std::chrono::steady_clock;
+
+    MinSpread result;
+    std::vector<char> buffer(std::max<size_t>(options.bufferBytes, 1));
+    size_t filled = 0;
+    size_t rows = 0;
+    bool header = true;
+    // Inside the rest of a line that did not fit in the buffer
+    bool skipping = false;
+
+    auto line = [&](const char* begin, const char* end) {
+        if (header) {
+            header = false;
+            return;
+        }
+        int day, maxTemp, minTemp;
+        if (!parse_row(begin, end, day, maxTemp, minTemp)) {
+            return;
+        }
+        result.add(day, maxTemp, minTemp);
+        ++rows;
+        if (options.everyRows && rows % options.everyRows == 0) {
+            report(result, rows);
+        }
+    };
+
+    Clock::time_point next = Clock::now() + options.every;
+    for (;;) {
+        // Wait for input no longer than the next timed report.
+        if (options.every.count() > 0) {
+            Clock::time_point now = Clock::now();
+            if (now >= next) {
+                report(result, rows);
+                next = now + options.every;
+            }
+            auto wait = std::chrono::ceil<std::chrono::milliseconds>(next - now);
+            struct pollfd ready = {fd, POLLIN, 0};
+            int count = poll(&ready, 1, static_cast<int>(wait.count()));
+            if (count == 0 || (count < 0 && errno == EINTR)) {
+                continue;
+            }
+            if (count < 0) {
+                return std::nullopt;
+            }
+        }
+
+        ssize_t bytes = read(fd, buffer.data() + filled, buffer.size() - filled);
+        if (bytes < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return std::nullopt;
+        }
+        if (bytes == 0) {
+            break;
+        }
+        filled += static_cast<size_t>(bytes);
+
+        const char* p = buffer.data();
+        const char* end = p + filled;
+        while (const char* newline = static_cast<const char*>(std::memchr(p, '\n', end - p))) {
+            if (!skipping) {
+                line(p, newline);
+            }
+            skipping = false;
+            p = newline + 1;
+        }
+
+        filled = static_cast<size_t>(end - p);
+        if (filled == buffer.size()) {
+            if (!skipping) {
+                line(p, end);
+            }
+            skipping = true;
+            filled = 0;
+        } else {
+            std::memmove(buffer.data(), p, filled);
+        }
+    }
+    if (filled && !skipping) {
+        line(buffer.data(), buffer.data() + filled);
+    }
+    return result;
+}
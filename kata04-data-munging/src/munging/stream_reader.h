@@ -0,0 +1,28 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <optional>
+
+#include "min_spread.h"
+
+struct StreamOptions {
+    // The whole working memory: lines are parsed in place in this buffer and
+    // the bytes of an unfinished line are moved to its front.
+    size_t bufferBytes = 64 * 1024;
+    // Report after every so many parsed rows, 0 for never.
+    size_t everyRows = 0;
+    // Report at this interval, even while no input arrives; 0 for never.
+    std::chrono::milliseconds every{0};
+};
+
+// Called with the running result and the number of rows parsed so far;
+// blank and unparseable lines are not counted.
+using StreamReport = std::function<void(const MinSpread& result, size_t rows)>;
+
+// Reads weather rows from fd (stdin, a FIFO, a file) until end of input with
+// constant memory, skipping the header line like the other parsers. A line
+// longer than the buffer is parsed from its first bufferBytes bytes. Empty
+// if reading fails.
+std::optional<MinSpread> min_spread_fd(int fd, const StreamOptions& options, const StreamReport& report);
@@ -0,0 +1,302 @@
+#include "table.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <limits>
+
+#include "row_parser.h"
+
+namespace {
+
+struct Slot {
+    size_t begin;
+    size_t end;
+};
+
+std::string_view trim(std::string_view s) {
+    while (!s.empty() && is_space(s.front())) {
+        s.remove_prefix(1);
+    }
+    while (!s.empty() && is_space(s.back())) {
+        s.remove_suffix(1);
+    }
+    return s;
+}
+
+// Separator rows such as "------" and blank lines carry no data.
+bool is_separator(std::string_view line) {
+    return std::all_of(line.begin(), line.end(), [](char c) { return c == '-' || c == '=' || is_space(c); });
+}
+
+bool has_alnum(std::string_view s) {
+    return std::any_of(s.begin(), s.end(), [](char c) {
+        return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+    });
+}
+
+bool parse_int_cell(std::string_view cell, int& value) {
+    auto result = std::from_chars(cell.data(), cell.data() + cell.size(), value);
+    return result.ec == std::errc() && result.ptr != cell.data() &&
+           std::all_of(result.ptr, cell.data() + cell.size(), [](char c) { return c == '*'; });
+}
+
+bool parse_float_cell(std::string_view cell, double& value) {
+    auto result = std::from_chars(cell.data(), cell.data() + cell.size(), value);
+    return result.ec == std::errc() && result.ptr != cell.data() &&
+           std::all_of(result.ptr, cell.data() + cell.size(), [](char c) { return c == '*'; });
+}
+
+std::vector<std::string_view> split_lines(std::string_view text) {
+    std::vector<std::string_view> lines;
+    while (!text.empty()) {
+        size_t newline = text.find('\n');
+        std::string_view line = text.substr(0, newline);
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        lines.push_back(line);
+        if (newline == std::string_view::npos) {
+            break;
+        }
+        text.remove_prefix(newline + 1);
+    }
+    return lines;
+}
+
+// Runs of character positions that are non-blank in at least one row.
+std::vector<Slot> find_slots(const std::vector<std::string_view>& rows) {
+    std::vector<uint8_t> used;
+    for (std::string_view row : rows) {
+        used.resize(std::max(used.size(), row.size()));
+        for (size_t i = 0; i < row.size(); ++i) {
+            used[i] |= !is_space(row[i]);
+        }
+    }
+
+    std::vector<Slot> slots;
+    for (size_t i = 0; i < used.size(); ++i) {
+        if (used[i] && (slots.empty() || slots.back().end != i)) {
+            slots.push_back({i, i + 1});
+        } else if (used[i]) {
+            slots.back().end = i + 1;
+        }
+    }
+    return slots;
+}
+
+std::string_view cell(std::string_view row, Slot slot) {
+    if (slot.begin >= row.size()) {
+        return {};
+    }
+    return trim(row.substr(slot.begin, slot.end - slot.begin));
+}
+
+// Gives each header name the slot its fields sit in. Headers are often
+// shifted against the data, so when there is one name per slot they are
+// matched in order; otherwise each name takes the slot nearest to it.
+std::vector<size_t> match_headers(std::string_view header, const std::vector<Slot>& slots,
+                                  std::vector<std::string_view>& names) {
+    std::vector<Slot> positions;
+    for (size_t i = 0; i < header.size();) {
+        if (is_space(header[i])) {
+            ++i;
+            continue;
+        }
+        size_t begin = i;
+        while (i < header.size() && !is_space(header[i])) {
+            ++i;
+        }
+        names.push_back(header.substr(begin, i - begin));
+        positions.push_back({begin, i});
+    }
+
+    std::vector<size_t> matched(names.size());
+    for (size_t n = 0; n < names.size(); ++n) {
+        if (names.size() == slots.size()) {
+            matched[n] = n;
+            continue;
+        }
+        size_t best = std::numeric_limits<size_t>::max();
+        for (size_t s = 0; s < slots.size(); ++s) {
+            size_t gap = 0;
+            if (slots[s].end <= positions[n].begin) {
+                gap = positions[n].begin - slots[s].end + 1;
+            } else if (positions[n].end <= slots[s].begin) {
+                gap = slots[s].begin - positions[n].end + 1;
+            }
+            if (gap < best) {
+                best = gap;
+                matched[n] = s;
+            }
+        }
+    }
+    return matched;
+}
+
+Column load_column(std::string_view name, const std::vector<std::string_view>& rows, Slot slot) {
+    Column column;
+    column.name = name;
+    column.present.resize(rows.size());
+
+    bool ints = true;
+    bool floats = true;
+    for (std::string_view row : rows) {
+        std::string_view text = cell(row, slot);
+        int i;
+        double f;
+        ints = ints && (text.empty() || parse_int_cell(text, i));
+        floats = floats && (text.empty() || parse_float_cell(text, f));
+    }
+
+    if (ints) {
+        column.type = ColumnType::Int;
+        column.ints.resize(rows.size());
+        for (size_t r = 0; r < rows.size(); ++r) {
+            column.present[r] = parse_int_cell(cell(rows[r], slot), column.ints[r]);
+        }
+    } else if (floats) {
+        column.type = ColumnType::Float;
+        column.floats.resize(rows.size());
+        for (size_t r = 0; r < rows.size(); ++r) {
+            column.present[r] = parse_float_cell(cell(rows[r], slot), column.floats[r]);
+        }
+    } else {
+        column.type = ColumnType::String;
+        column.strings.resize(rows.size());
+        for (size_t r = 0; r < rows.size(); ++r) {
+            column.strings[r] = cell(rows[r], slot);
+            column.present[r] = !column.strings[r].empty();
+        }
+    }
+    return column;
+}
+
+// Rows per block in min_abs_difference: each block's distances are computed
+// without branches, so the compiler can vectorize them, and only blocks that
+// beat the best so far are searched for the row.
+const size_t BLOCK = 16;
+
+template <typename A, typename B>
+std::optional<size_t> min_abs_difference(const A* a, const B* b, const uint8_t* presentA, const uint8_t* presentB,
+                                         size_t rows) {
+    const double missing = std::numeric_limits<double>::infinity();
+    double best = missing;
+    size_t bestRow = 0;
+    double distance[BLOCK];
+    for (size_t begin = 0; begin < rows; begin += BLOCK) {
+        size_t count = std::min(BLOCK, rows - begin);
+        double blockBest = missing;
+        for (size_t i = 0; i < count; ++i) {
+            size_t r = begin + i;
+            double d = std::fabs(static_cast<double>(a[r]) - static_cast<double>(b[r]));
+            distance[i] = (presentA[r] & presentB[r]) ? d : missing;
+            blockBest = std::min(blockBest, distance[i]);
+        }
+        if (blockBest < best) {
+            best = blockBest;
+            bestRow = begin + static_cast<size_t>(std::find(distance, distance + count, blockBest) - distance);
+        }
+    }
+    if (best == missing) {
+        return std::nullopt;
+    }
+    return bestRow;
+}
+
+template <typename A>
+std::optional<size_t> min_abs_difference(const A* a, const Column& columnA, const Column& b) {
+    size_t rows = std::min(columnA.present.size(), b.present.size());
+    if (b.type == ColumnType::Int) {
+        return min_abs_difference(a, b.ints.data(), columnA.present.data(), b.present.data(), rows);
+    }
+    return min_abs_difference(a, b.floats.data(), columnA.present.data(), b.present.data(), rows);
+}
+
+} // namespace
+
+std::string Column::text(size_t row) const {
+    if (!present[row]) {
+        return {};
+    }
+    switch (type) {
+    case ColumnType::Int:
+        return std::to_string(ints[row]);
+    case ColumnType::Float: {
+        char buffer[64];
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), floats[row]);
+        return std::string(buffer, result.ptr);
+    }
+    case ColumnType::String:
+        break;
+    }
+    return strings[row];
+}
+
+Table Table::parse(std::string_view text) {
+    Table table;
+    std::vector<std::string_view> lines = split_lines(text);
+    if (lines.empty()) {
+        return table;
+    }
+
+    std::vector<std::string_view> rows;
+    for (size_t i = 1; i < lines.size(); ++i) {
+        if (!is_separator(lines[i])) {
+            rows.push_back(lines[i]);
+        }
+    }
+
+    for (const ColumnSpan& span : find_columns(lines[0], rows)) {
+        table.columns_.push_back(load_column(span.name, rows, {span.begin, span.end}));
+    }
+    table.rows_ = rows.size();
+    return table;
+}
+
+std::vector<ColumnSpan> find_columns(std::string_view header, const std::vector<std::string_view>& rows) {
+    // Slots holding only punctuation, like the "-" between goals for and
+    // against, are not columns.
+    std::vector<Slot> slots;
+    for (Slot slot : find_slots(rows)) {
+        if (std::any_of(rows.begin(), rows.end(), [&](std::string_view row) { return has_alnum(cell(row, slot)); })) {
+            slots.push_back(slot);
+        }
+    }
+
+    std::vector<std::string_view> names;
+    std::vector<size_t> matched = match_headers(header, slots, names);
+    std::vector<ColumnSpan> columns;
+    for (size_t n = 0; n < names.size(); ++n) {
+        Slot slot = matched[n] < slots.size() ? slots[matched[n]] : Slot{0, 0};
+        columns.push_back({std::string(names[n]), slot.begin, slot.end});
+    }
+    return columns;
+}
+
+std::string_view column_cell(std::string_view row, const ColumnSpan& span) {
+    return cell(row, {span.begin, span.end});
+}
+
+bool parse_number(std::string_view cell, double& value) {
+    return parse_float_cell(cell, value);
+}
+
+const Column* Table::find(std::string_view name) const {
+    for (const Column& column : columns_) {
+        if (column.name == name) {
+            return &column;
+        }
+    }
+    return nullptr;
+}
+
+std::optional<size_t> min_abs_difference(const Column& a, const Column& b) {
+    if (a.type == ColumnType::String || b.type == ColumnType::String) {
+        return std::nullopt;
+    }
+    if (a.type == ColumnType::Int) {
+        return min_abs_difference(a.ints.data(), a, b);
+    }
+    return min_abs_difference(a.floats.data(), a, b);
+}
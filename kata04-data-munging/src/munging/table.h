@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+enum class ColumnType { Int, Float, String };
+
+// One column of a Table, stored as a single array. Only the vector matching
+// type is filled; present is 0 for blank cells and cells of another type.
+struct Column {
+    std::string name;
+    ColumnType type = ColumnType::Int;
+    std::vector<int> ints;
+    std::vector<double> floats;
+    std::vector<std::string> strings;
+    std::vector<uint8_t> present;
+
+    // The cell as text, empty when missing.
+    std::string text(size_t row) const;
+};
+
+// A .dat file loaded column by column: a header line naming the columns,
+// then rows of fixed-width fields.
+class Table {
+public:
+    Table() = default;
+    Table(std::vector<Column> columns, size_t rows) : columns_(std::move(columns)), rows_(rows) {}
+
+    // Field boundaries come from the character positions that are blank in
+    // every row; lines of only dashes and blanks are separators and skipped.
+    // A column holds ints if every cell is an integer (a trailing '*' flag
+    // is ignored), floats if every cell is a number, strings otherwise.
+    static Table parse(std::string_view text);
+
+    size_t rows() const { return rows_; }
+    const std::vector<Column>& columns() const { return columns_; }
+    // nullptr when no column has that name.
+    const Column* find(std::string_view name) const;
+
+private:
+    std::vector<Column> columns_;
+    size_t rows_ = 0;
+};
+
+// Where a named column sits in each row of a fixed-width file: the
+// characters [begin, end).
+struct ColumnSpan {
+    std::string name;
+    size_t begin;
+    size_t end;
+};
+
+// The columns Table::parse would load, from the header and the data rows
+// (separators left out). A sample of the rows is enough for streaming.
+std::vector<ColumnSpan> find_columns(std::string_view header, const std::vector<std::string_view>& rows);
+
+// The trimmed text of a column in one row, empty past the end of the row.
+std::string_view column_cell(std::string_view row, const ColumnSpan& span);
+
+// Reads a cell as a number, ignoring a trailing '*' flag.
+bool parse_number(std::string_view cell, double& value);
+
+// The first row with the smallest |a - b|, skipping rows where either cell
+// is missing. Empty if there is no such row or either column holds strings.
+std::optional<size_t> min_abs_difference(const Column& a, const Column& b);
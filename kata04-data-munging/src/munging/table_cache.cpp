@@ -0,0 +1,263 @@
+#include "table_cache.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include "mapped_file.h"
+
+namespace {
+
+const char MAGIC[8] = {'D', 'A', 'T', 'C', 'O', 'L', '1', '\n'};
+// Bytes hashed at the start, middle and end of the source.
+const size_t SAMPLE_BYTES = 64 * 1024;
+
+struct CacheHeader {
+    char magic[8];
+    uint64_t sourceSize;
+    int64_t sourceMtime;
+    uint64_t sourceHash;
+    uint64_t rows;
+    uint64_t columns;
+};
+
+struct ColumnHeader {
+    uint32_t type;
+    uint32_t nameLength;
+    // 1 when every cell is present and the presence bytes are left out.
+    uint32_t allPresent;
+    uint32_t unused;
+    // Bytes of string data after the offsets, 0 for numeric columns.
+    uint64_t stringBytes;
+};
+
+size_t padded(size_t bytes) {
+    return (bytes + 7) & ~size_t(7);
+}
+
+uint64_t fnv1a(const char* data, size_t size, uint64_t hash) {
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ static_cast<unsigned char>(data[i])) * 1099511628211ull;
+    }
+    return hash;
+}
+
+// Hashing the whole source would cost as much as parsing it, so only three
+// blocks are hashed; size and modification time catch the other edits.
+uint64_t sample_hash(std::string_view text) {
+    uint64_t hash = 14695981039346656037ull;
+    size_t sample = std::min(text.size(), SAMPLE_BYTES);
+    hash = fnv1a(text.data(), sample, hash);
+    hash = fnv1a(text.data() + (text.size() - sample) / 2, sample, hash);
+    return fnv1a(text.data() + text.size() - sample, sample, hash);
+}
+
+// Describes the source as it was mapped, so the stamp matches the bytes read
+// even if the file is replaced meanwhile.
+CacheHeader stamp_source(const MappedFile& source) {
+    CacheHeader header = {};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.sourceSize = source.data().size();
+    header.sourceMtime = source.mtime();
+    header.sourceHash = sample_hash(source.data());
+    return header;
+}
+
+// Walks the mapped sidecar, failing on anything past its end.
+class Reader {
+public:
+    explicit Reader(std::string_view data) : data_(data) {}
+
+    const char* take(size_t bytes) {
+        if (bytes > data_.size() - offset_) {
+            return nullptr;
+        }
+        const char* p = data_.data() + offset_;
+        offset_ += padded(bytes);
+        offset_ = std::min(offset_, data_.size());
+        return p;
+    }
+
+    template <typename T>
+    bool read(T& value) {
+        const char* p = take(sizeof(T));
+        if (p) {
+            std::memcpy(&value, p, sizeof(T));
+        }
+        return p != nullptr;
+    }
+
+    template <typename T>
+    bool read_array(std::vector<T>& values, size_t count) {
+        if (count > data_.size() / sizeof(T)) {
+            return false;
+        }
+        const char* p = take(count * sizeof(T));
+        if (p) {
+            values.resize(count);
+            std::memcpy(values.data(), p, count * sizeof(T));
+        }
+        return p != nullptr;
+    }
+
+private:
+    std::string_view data_;
+    size_t offset_ = 0;
+};
+
+bool read_column(Reader& reader, size_t rows, Column& column) {
+    ColumnHeader header;
+    if (!reader.read(header) || header.type > static_cast<uint32_t>(ColumnType::String)) {
+        return false;
+    }
+    const char* name = reader.take(header.nameLength);
+    if (!name) {
+        return false;
+    }
+    if (header.allPresent) {
+        column.present.assign(rows, 1);
+    } else if (!reader.read_array(column.present, rows)) {
+        return false;
+    }
+    column.name.assign(name, header.nameLength);
+    column.type = static_cast<ColumnType>(header.type);
+
+    switch (column.type) {
+    case ColumnType::Int:
+        return reader.read_array(column.ints, rows);
+    case ColumnType::Float:
+        return reader.read_array(column.floats, rows);
+    case ColumnType::String:
+        break;
+    }
+    std::vector<uint64_t> offsets;
+    const char* chars = nullptr;
+    if (!reader.read_array(offsets, rows + 1) || !(chars = reader.take(header.stringBytes))) {
+        return false;
+    }
+    column.strings.resize(rows);
+    for (size_t r = 0; r < rows; ++r) {
+        if (offsets[r] > offsets[r + 1] || offsets[r + 1] > header.stringBytes) {
+            return false;
+        }
+        column.strings[r].assign(chars + offsets[r], offsets[r + 1] - offsets[r]);
+    }
+    return true;
+}
+
+void write_padded(std::ofstream& out, const void* data, size_t bytes) {
+    static const char zeros[8] = {};
+    out.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+    out.write(zeros, static_cast<std::streamsize>(padded(bytes) - bytes));
+}
+
+// Writes the sidecar for path through a temporary file and a rename.
+bool write_sidecar(const std::string& path, CacheHeader header, const Table& table) {
+    header.rows = table.rows();
+    header.columns = table.columns().size();
+
+    std::string temporary = table_cache_path(path) + ".tmp";
+    std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        return false;
+    }
+    write_padded(out, &header, sizeof(header));
+    for (const Column& column : table.columns()) {
+        std::vector<uint64_t> offsets;
+        std::string chars;
+        if (column.type == ColumnType::String) {
+            offsets.push_back(0);
+            for (const std::string& s : column.strings) {
+                chars += s;
+                offsets.push_back(chars.size());
+            }
+        }
+
+        bool allPresent = std::all_of(column.present.begin(), column.present.end(), [](uint8_t p) { return p; });
+        ColumnHeader columnHeader = {static_cast<uint32_t>(column.type), static_cast<uint32_t>(column.name.size()),
+                                     allPresent, 0, chars.size()};
+        write_padded(out, &columnHeader, sizeof(columnHeader));
+        write_padded(out, column.name.data(), column.name.size());
+        if (!allPresent) {
+            write_padded(out, column.present.data(), column.present.size());
+        }
+        switch (column.type) {
+        case ColumnType::Int:
+            write_padded(out, column.ints.data(), column.ints.size() * sizeof(int));
+            break;
+        case ColumnType::Float:
+            write_padded(out, column.floats.data(), column.floats.size() * sizeof(double));
+            break;
+        case ColumnType::String:
+            write_padded(out, offsets.data(), offsets.size() * sizeof(uint64_t));
+            write_padded(out, chars.data(), chars.size());
+            break;
+        }
+    }
+    out.close();
+    if (!out || std::rename(temporary.c_str(), table_cache_path(path).c_str()) != 0) {
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+std::string table_cache_path(const std::string& path) {
+    return path + ".col";
+}
+
+std::optional<Table> read_table_cache(const std::string& path) {
+    MappedFile source(path);
+    MappedFile cache(table_cache_path(path));
+    if (!source.is_open() || !cache.is_open()) {
+        return std::nullopt;
+    }
+    CacheHeader expected = stamp_source(source);
+
+    Reader reader(cache.data());
+    CacheHeader header;
+    if (!reader.read(header) || std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+        header.sourceSize != expected.sourceSize || header.sourceMtime != expected.sourceMtime ||
+        header.sourceHash != expected.sourceHash || header.rows > cache.data().size()) {
+        return std::nullopt;
+    }
+
+    std::vector<Column> columns(header.columns > cache.data().size() ? 0 : header.columns);
+    if (columns.size() != header.columns) {
+        return std::nullopt;
+    }
+    for (Column& column : columns) {
+        if (!read_column(reader, header.rows, column)) {
+            return std::nullopt;
+        }
+    }
+    return Table(std::move(columns), header.rows);
+}
+
+bool write_table_cache(const std::string& path, const Table& table) {
+    MappedFile source(path);
+    return source.is_open() && write_sidecar(path, stamp_source(source), table);
+}
+
+std::optional<Table> load_table(const std::string& path, bool useCache) {
+    if (useCache) {
+        if (std::optional<Table> cached = read_table_cache(path)) {
+            return cached;
+        }
+    }
+
+    MappedFile file(path);
+    if (!file.is_open()) {
+        return std::nullopt;
+    }
+    std::optional<Table> table = Table::parse(file.data());
+    if (useCache) {
+        // Stamped from the mapping just parsed, never from a later look at
+        // the path.
+        write_sidecar(path, stamp_source(file), *table);
+    }
+    return table;
+}
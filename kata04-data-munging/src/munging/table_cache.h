@@ -0,0 +1,28 @@
+#pragma once
+
+#include <optional>
+#include <string>
+
+#include "table.h"
+
+// A parsed table is cached in a binary sidecar next to its source,
+// <path>.col: a header describing the source, then for each column its
+// name, type, presence bytes (left out when every cell is present) and
+// values as flat arrays, read back in one pass over a memory mapping. The
+// sidecar is only used while the source has the same size, modification
+// time and hash of sampled blocks, all taken from the mapping that is read.
+
+// The sidecar path for a source file.
+std::string table_cache_path(const std::string& path);
+
+// The table cached for path, or empty if there is no valid sidecar.
+std::optional<Table> read_table_cache(const std::string& path);
+
+// Writes the sidecar for path through a temporary file and a rename, so a
+// reader never sees half of one; table must be parsed from path as it is
+// now. Returns false if it could not be written.
+bool write_table_cache(const std::string& path, const Table& table);
+
+// The table for path from its sidecar, or parsed from the text, writing the
+// sidecar for next time. Empty if path cannot be read.
+std::optional<Table> load_table(const std::string& path, bool useCache = true);
@@ -0,0 +1,175 @@
+#include "watch.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+#include "row_parser.h"
+
+namespace {
+
+// Bytes before the offset that must be unchanged to carry on from it.
+const size_t CHECK_BYTES = 64;
+
+uint64_t check_before(int fd, uint64_t offset) {
+    char bytes[CHECK_BYTES];
+    size_t size = static_cast<size_t>(std::min<uint64_t>(offset, CHECK_BYTES));
+    ssize_t read = pread(fd, bytes, size, static_cast<off_t>(offset - size));
+    uint64_t hash = 14695981039346656037ull;
+    for (ssize_t i = 0; i < read; ++i) {
+        hash = (hash ^ static_cast<unsigned char>(bytes[i])) * 1099511628211ull;
+    }
+    return read == static_cast<ssize_t>(size) ? hash : 0;
+}
+
+} // namespace
+
+WatchState load_watch_state(const std::string& statePath) {
+    WatchState state;
+    std::ifstream in(statePath);
+    std::string key;
+    uint64_t value;
+    while (in >> key >> value) {
+        if (key == "device") {
+            state.device = value;
+        } else if (key == "inode") {
+            state.inode = value;
+        } else if (key == "offset") {
+            state.offset = value;
+        } else if (key == "check") {
+            state.check = value;
+        } else if (key == "rows") {
+            state.rows = value;
+        } else if (key == "day") {
+            state.result.day = static_cast<int>(value);
+        } else if (key == "spread") {
+            state.result.spread = static_cast<int>(static_cast<int64_t>(value));
+        }
+    }
+    return state;
+}
+
+bool save_watch_state(const std::string& statePath, const WatchState& state) {
+    std::string temporary = statePath + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::trunc);
+        out << "device " << state.device << "\n"
+            << "inode " << state.inode << "\n"
+            << "offset " << state.offset << "\n"
+            << "check " << state.check << "\n"
+            << "rows " << state.rows << "\n"
+            << "day " << static_cast<uint64_t>(static_cast<int64_t>(state.result.day)) << "\n"
+            << "spread " << static_cast<uint64_t>(static_cast<int64_t>(state.result.spread)) << "\n";
+        if (!out) {
+            return false;
+        }
+    }
+    return std::rename(temporary.c_str(), statePath.c_str()) == 0;
+}
+
+bool catch_up(const std::string& path, WatchState& state) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return false;
+    }
+
+    bool same = state.device == static_cast<uint64_t>(st.st_dev) && state.inode == static_cast<uint64_t>(st.st_ino) &&
+                state.offset <= static_cast<uint64_t>(st.st_size) && check_before(fd, state.offset) == state.check;
+    if (!same) {
+        state = WatchState();
+        state.device = static_cast<uint64_t>(st.st_dev);
+        state.inode = static_cast<uint64_t>(st.st_ino);
+    }
+
+    std::vector<char> buffer(64 * 1024);
+    for (;;) {
+        ssize_t bytes = pread(fd, buffer.data(), buffer.size(), static_cast<off_t>(state.offset));
+        if (bytes < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytes <= 0) {
+            break;
+        }
+
+        const char* start = buffer.data();
+        const char* p = start;
+        const char* end = p + bytes;
+        while (const char* newline = static_cast<const char*>(std::memchr(p, '\n', end - p))) {
+            // The first line of the file is the header.
+            int day, maxTemp, minTemp;
+            if (state.offset + static_cast<uint64_t>(p - start) != 0 && parse_row(p, newline, day, maxTemp, minTemp)) {
+                state.result.add(day, maxTemp, minTemp);
+                ++state.rows;
+            }
+            p = newline + 1;
+        }
+
+        if (p == start) {
+            // A partial last line waits for the rest; a longer line than the
+            // buffer gets a bigger buffer.
+            if (static_cast<size_t>(bytes) < buffer.size()) {
+                break;
+            }
+            buffer.resize(buffer.size() * 2);
+        }
+        state.offset += static_cast<uint64_t>(p - start);
+    }
+    state.check = check_before(fd, state.offset);
+    close(fd);
+    return true;
+}
+
+bool watch_file(const std::string& path, const std::string& statePath,
+                const std::function<void(const WatchState&)>& report) {
+    // Watching the directory also sees the file being replaced by a new one.
+    size_t slash = path.find_last_of('/');
+    std::string directory = slash == std::string::npos ? "." : path.substr(0, slash + 1);
+    std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+
+    int fd = inotify_init1(IN_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    if (inotify_add_watch(fd, directory.c_str(), IN_MODIFY | IN_CLOSE_WRITE | IN_CREATE | IN_MOVED_TO) < 0) {
+        close(fd);
+        return false;
+    }
+
+    WatchState state = load_watch_state(statePath);
+    bool changed = true;
+    std::vector<char> events(64 * 1024);
+    for (;;) {
+        if (changed && catch_up(path, state)) {
+            save_watch_state(statePath, state);
+            report(state);
+        }
+
+        // Sleep until something happens to the file.
+        ssize_t bytes = read(fd, events.data(), events.size());
+        if (bytes < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytes <= 0) {
+            close(fd);
+            return false;
+        }
+        changed = false;
+        for (const char* p = events.data(); p < events.data() + bytes;) {
+            const inotify_event* event = reinterpret_cast<const inotify_event*>(p);
+            changed = changed || (event->len && name == event->name);
+            p += sizeof(inotify_event) + event->len;
+        }
+    }
+}
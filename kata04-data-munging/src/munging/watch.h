@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "min_spread.h"
+
+// How far a file has been read and the answer up to there, enough to carry
+// on with only the bytes appended since.
+struct WatchState {
+    uint64_t device = 0;
+    uint64_t inode = 0;
+    // Bytes read, always up to the end of a complete line
+    uint64_t offset = 0;
+    // Hash of the bytes just before offset, to notice a rewritten file
+    uint64_t check = 0;
+    uint64_t rows = 0;
+    MinSpread result;
+};
+
+// The state saved at statePath, or a fresh one if there is none.
+WatchState load_watch_state(const std::string& statePath);
+
+// Saves state through a temporary file and a rename. Returns false if it
+// could not be written.
+bool save_watch_state(const std::string& statePath, const WatchState& state);
+
+// Parses the complete lines of path after state.offset; a final line without
+// its newline waits for the next call. A file that was replaced (another
+// inode), truncated below offset or changed in the bytes just before it is
+// read again from the start. Returns false if path cannot be read.
+bool catch_up(const std::string& path, WatchState& state);
+
+// Catches up, then sleeps on inotify and catches up again whenever the file
+// is written, truncated or replaced, saving the state and calling report
+// after each change. Only returns if watching fails.
+bool watch_file(const std::string& path, const std::string& statePath,
+                const std::function<void(const WatchState&)>& report);
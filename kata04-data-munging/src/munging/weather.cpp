@@ -0,0 +1,149 @@
+#include "weather.h"
+
+#include <cstring>
+#include <sstream>
+#include <string>
+
+#include "row_parser.h"
+#include "simd_scanner.h"
+#include "weather_schema.h"
+
+MinSpread min_spread_stream(std::istream& in) {
+    std::string line;
+    MinSpread result;
+
+    // Skip the header line
+    std::getline(in, line);
+
+    while (std::getline(in, line)) {
+        std::istringstream iss(line);
+        int day, maxTemp, minTemp;
+        if (!(iss >> day >> maxTemp >> minTemp)) {
+            continue; // Skip lines that don't match the expected format
+        }
+        result.add(day, maxTemp, minTemp);
+    }
+    return result;
+}
+
+MinSpread min_spread_text(std::string_view text) {
+    MinSpread result;
+    if (text.empty()) {
+        return result;
+    }
+    const char* p = text.data();
+    const char* end = p + text.size();
+
+    // Skip the header line
+    const char* newline = static_cast<const char*>(std::memchr(p, '\n', end - p));
+    p = newline ? newline + 1 : end;
+
+    while (p != end) {
+        newline = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        const char* lineEnd = newline ? newline : end;
+        int day, maxTemp, minTemp;
+        if (parse_row(p, lineEnd, day, maxTemp, minTemp)) {
+            result.add(day, maxTemp, minTemp);
+        }
+        p = newline ? newline + 1 : end;
+    }
+    return result;
+}
+
+// Drops the events of the current line still pending in events, keeping the
+// newline that ends it and everything after.
+static uint64_t skip_rest_of_line(uint64_t events, uint64_t newlines) {
+    uint64_t pending = events & newlines;
+    return pending ? events & ~((pending & -pending) - 1) : 0;
+}
+
+MinSpread min_spread_simd(std::string_view text) {
+    // Skip the header line
+    const char* newline = static_cast<const char*>(std::memchr(text.data(), '\n', text.size()));
+    if (!newline) {
+        return MinSpread();
+    }
+    return min_spread_rows(text.substr(newline + 1 - text.data()));
+}
+
+MinSpread min_spread_rows(std::string_view rows) {
+    MinSpread result;
+    const char* end = rows.data() + rows.size();
+    const char* lineStart = rows.data();
+    const char* fields[3];
+    unsigned fieldCount = 0;
+
+    // Reads the first three fields as short decimal numbers straight from
+    // their starts. Anything else (a '+', long numbers, "12-5", fewer than
+    // three fields) is rare and goes through parse_row, so the answer always
+    // matches the stream loop.
+    auto finish = [&](const char* lineEnd) {
+        int values[3];
+        bool fast = fieldCount == 3;
+        for (unsigned k = 0; k < 3 && fast; ++k) {
+            const char* p = fields[k];
+            bool negative = *p == '-';
+            p += negative;
+            const char* digits = p;
+            int value = 0;
+            while (p != lineEnd && p - digits < 9 && static_cast<unsigned>(*p - '0') < 10) {
+                value = value * 10 + (*p++ - '0');
+            }
+            // The stream stops after the digits; only the last field may be
+            // followed by something other than whitespace.
+            fast = p != digits && (p == lineEnd || (k == 2 ? static_cast<unsigned>(*p - '0') >= 10 : is_space(*p)));
+            values[k] = negative ? -value : value;
+        }
+        if (fast || (fieldCount > 0 && parse_row(lineStart, lineEnd, values[0], values[1], values[2]))) {
+            result.add(values[0], values[1], values[2]);
+        }
+    };
+
+    // The start of a line counts as following whitespace.
+    uint64_t carry = 1;
+    char tail[64];
+    for (const char* block = lineStart; block < end; block += 64) {
+        const char* data = block;
+        if (end - block < 64) {
+            std::memset(tail, ' ', sizeof(tail));
+            std::memcpy(tail, block, end - block);
+            data = tail;
+        }
+
+        BlockMasks masks = classify_block(data);
+        uint64_t starts = ~masks.spaces & ((masks.spaces << 1) | carry);
+        carry = masks.spaces >> 63;
+
+        uint64_t events = starts | masks.newlines;
+        if (fieldCount == 3) {
+            events = skip_rest_of_line(events, masks.newlines);
+        }
+        while (events) {
+            unsigned i = __builtin_ctzll(events);
+            events &= events - 1;
+            if (masks.newlines >> i & 1) {
+                finish(block + i);
+                lineStart = block + i + 1;
+                fieldCount = 0;
+            } else {
+                fields[fieldCount++] = block + i;
+                if (fieldCount == 3) {
+                    events = skip_rest_of_line(events, masks.newlines);
+                }
+            }
+        }
+    }
+    if (lineStart < end) {
+        finish(end);
+    }
+    return result;
+}
+
+MinSpread min_spread_schema(std::string_view text) {
+    using Parser = schema::RowParser<WeatherSchema, weather::Dy, weather::MxT, weather::MnT>;
+    MinSpread result;
+    schema::for_each_row<Parser>(text, [&](const Parser::Row& row) {
+        result.add(std::get<0>(row), std::get<1>(row), std::get<2>(row));
+    });
+    return result;
+}
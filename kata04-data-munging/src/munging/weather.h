@@ -0,0 +1,30 @@
+#pragma once
+
+#include <istream>
+#include <string_view>
+
+#include "min_spread.h"
+
+// The original part1 loop: getline plus an istringstream per line.
+MinSpread min_spread_stream(std::istream& in);
+
+// Same answer from text already in memory, parsed in place without
+// allocating.
+MinSpread min_spread_text(std::string_view text);
+
+// Same answer again, with line and field boundaries found 64 bytes at a time
+// by the SIMD scanner.
+MinSpread min_spread_simd(std::string_view text);
+
+// The answer from the parser WeatherSchema generates for Dy, MxT and MnT.
+// Unlike the stream loop it reads flagged values such as "97*" instead of
+// dropping their rows; summary rows, whose Dy is not a number, are skipped.
+MinSpread min_spread_schema(std::string_view text);
+
+// The SIMD scanner over data rows only, without the header line.
+MinSpread min_spread_rows(std::string_view rows);
+
+// min_spread_rows over newline-aligned chunks of the rows, parsed by a pool
+// of threads and reduced in file order so that ties still go to the first
+// day.
+MinSpread min_spread_parallel(std::string_view text, unsigned threads);
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <string_view>
+
+#include "schema.h"
+
+// The columns of weather.dat, for schema::RowParser.
+struct WeatherSchema {
+    static constexpr std::string_view header =
+        "Dy MxT MnT AvT HDDay AvDP 1HrP TPcpn WxType PDir AvSp Dir MxS SkyC MxR MnR AvSLP";
+};
+
+namespace weather {
+
+struct Dy {
+    static constexpr std::string_view name = "Dy";
+    using type = int;
+};
+
+struct MxT {
+    static constexpr std::string_view name = "MxT";
+    using type = int;
+};
+
+struct MnT {
+    static constexpr std::string_view name = "MnT";
+    using type = int;
+};
+
+struct AvT {
+    static constexpr std::string_view name = "AvT";
+    using type = double;
+};
+
+} // namespace weather
@@ -1,39 +1,222 @@
+#include <algorithm>
+#include <fcntl.h>
 #include <iostream>
 #include <fstream>
-#include <sstream>
 #include <string>
-#include <limits>
+#include <thread>
+#include <unistd.h>
+#include <vector>
 
-int main() {
-    std::ifstream file("data/weather.dat");
-    if (!file.is_open()) {
-        std::cerr << "Failed to open file." << std::endl;
-        return 1;
-    }
-
-    std::string line;
-    int minSpreadDay = 0;
-    int minSpread = std::numeric_limits<int>::max();
+#include "aggregate.h"
+#include "batch.h"
+#ifdef HAVE_ZLIB
+#include "compressed_reader.h"
+#endif
+#include "mapped_file.h"
+#include "stream_reader.h"
+#include "watch.h"
+#include "weather.h"
+#include "weather_schema.h"
 
-    // Skip the header line
-    std::getline(file, line);
+int main(int argc, char* argv[]) {
+    std::string path = "data/weather.dat";
+    std::string mode = "stream";
+    bool pathGiven = false;
+    unsigned threads = std::thread::hardware_concurrency();
+    StreamOptions options;
+    BatchOptions batch;
+    std::vector<std::string> inputs;
+    std::string statePath;
+    bool once = false;
+    std::string aggregates = "min:MxT-MnT,max:MxT-MnT,avg:MxT-MnT,avg:AvT,top3:MxT-MnT,p50:MxT-MnT,p90:MxT-MnT";
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.rfind("--mode=", 0) == 0) {
+            mode = arg.substr(7);
+        } else if (arg.rfind("--threads=", 0) == 0) {
+            threads = std::stoul(arg.substr(10));
+            batch.threads = threads;
+        } else if (arg.rfind("--aggregates=", 0) == 0) {
+            aggregates = arg.substr(13);
+        } else if (arg.rfind("--state=", 0) == 0) {
+            statePath = arg.substr(8);
+        } else if (arg == "--once") {
+            once = true;
+        } else if (arg == "--io=threads") {
+            batch.io = BatchIo::Threads;
+        } else if (arg == "--io=uring") {
+            batch.io = BatchIo::Uring;
+        } else if (arg.rfind("--every-rows=", 0) == 0) {
+            options.everyRows = std::stoull(arg.substr(13));
+        } else if (arg.rfind("--every-ms=", 0) == 0) {
+            options.every = std::chrono::milliseconds(std::stoll(arg.substr(11)));
+        } else {
+            path = arg;
+            pathGiven = true;
+            inputs.push_back(arg);
+        }
+    }
 
-    while (std::getline(file, line)) {
-        std::istringstream iss(line);
-        int day, maxTemp, minTemp;
-        if (!(iss >> day >> maxTemp >> minTemp)) {
-            continue; // Skip lines that don't match the expected format
+    MinSpread result;
+    if (mode == "stream") {
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open file." << std::endl;
+            return 1;
+        }
+        result = min_spread_stream(file);
+        file.close();
+    } else if (mode == "mmap") {
+        MappedFile file(path);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open file." << std::endl;
+            return 1;
+        }
+        result = min_spread_text(file.data());
+    } else if (mode == "simd") {
+        MappedFile file(path);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open file." << std::endl;
+            return 1;
+        }
+        result = min_spread_simd(file.data());
+    } else if (mode == "schema") {
+        MappedFile file(path);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open file." << std::endl;
+            return 1;
+        }
+        std::string_view text = file.data();
+        if (!schema::header_matches<WeatherSchema>(text.substr(0, text.find('\n')))) {
+            std::cerr << "The header does not match the weather schema." << std::endl;
+            return 1;
+        }
+        result = min_spread_schema(text);
+#ifdef HAVE_ZLIB
+    } else if (mode == "gzip") {
+        std::optional<MinSpread> inflated = min_spread_gzip(path);
+        if (!inflated) {
+            std::cerr << "Failed to read compressed file." << std::endl;
+            return 1;
+        }
+        result = *inflated;
+#endif
+    } else if (mode == "parallel") {
+        MappedFile file(path);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open file." << std::endl;
+            return 1;
+        }
+        result = min_spread_parallel(file.data(), threads);
+    } else if (mode == "pipe") {
+        // stdin unless a file (or FIFO) is named
+        int fd = pathGiven ? open(path.c_str(), O_RDONLY) : STDIN_FILENO;
+        if (fd < 0) {
+            std::cerr << "Failed to open file." << std::endl;
+            return 1;
+        }
+        std::optional<MinSpread> streamed = min_spread_fd(fd, options, [](const MinSpread& partial, size_t rows) {
+            std::cout << "After " << rows << " rows, day with the smallest temperature spread: " << partial.day
+                      << std::endl;
+        });
+        if (pathGiven) {
+            close(fd);
+        }
+        if (!streamed) {
+            std::cerr << "Failed to read input." << std::endl;
+            return 1;
+        }
+        result = *streamed;
+    } else if (mode == "watch") {
+        // Carries on from the state of the last run and reads only what was
+        // appended since.
+        if (statePath.empty()) {
+            statePath = path + ".state";
+        }
+        if (once) {
+            WatchState state = load_watch_state(statePath);
+            if (!catch_up(path, state)) {
+                std::cerr << "Failed to open file." << std::endl;
+                return 1;
+            }
+            save_watch_state(statePath, state);
+            result = state.result;
+        } else {
+            watch_file(path, statePath, [](const WatchState& state) {
+                std::cout << "After " << state.rows << " rows, day with the smallest temperature spread: "
+                          << state.result.day << std::endl;
+            });
+            std::cerr << "Failed to watch file." << std::endl;
+            return 1;
+        }
+    } else if (mode == "batch") {
+        // Every file named, and the files in every directory named
+        std::vector<std::string> paths;
+        for (const std::string& input : inputs.empty() ? std::vector<std::string>{path} : inputs) {
+            std::vector<std::string> listed = list_directory(input);
+            paths.insert(paths.end(), listed.begin(), listed.end());
+            if (listed.empty()) {
+                paths.push_back(input);
+            }
+        }
+        std::vector<FileResult> files = min_spread_files(paths, batch);
+        for (const FileResult& file : files) {
+            if (file.ok && file.result.spread == std::numeric_limits<int>::max()) {
+                std::cout << file.path << ": no rows" << std::endl;
+            } else if (file.ok) {
+                std::cout << file.path << ": day " << file.result.day << " (spread " << file.result.spread << ")"
+                          << std::endl;
+            } else {
+                std::cout << file.path << ": failed to read" << std::endl;
+            }
+        }
+        std::optional<size_t> best = min_spread_best(files);
+        if (!best) {
+            std::cerr << "No rows in any file." << std::endl;
+            return 1;
+        }
+        std::cout << "Day with the smallest temperature spread: " << files[*best].result.day << " in "
+                  << files[*best].path << std::endl;
+        return 0;
+    } else if (mode == "aggregate") {
+        std::vector<AggregateSpec> specs;
+        for (size_t begin = 0; begin <= aggregates.size();) {
+            size_t comma = std::min(aggregates.find(',', begin), aggregates.size());
+            std::optional<AggregateSpec> spec = parse_aggregate(std::string_view(aggregates).substr(begin, comma - begin));
+            if (!spec) {
+                std::cerr << "Bad aggregate " << aggregates.substr(begin, comma - begin) << std::endl;
+                return 1;
+            }
+            specs.push_back(*spec);
+            begin = comma + 1;
+        }
+        MappedFile file(path);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open file." << std::endl;
+            return 1;
         }
 
-        int spread = maxTemp - minTemp;
-        if (spread < minSpread) {
-            minSpread = spread;
-            minSpreadDay = day;
+        // All of them in a single pass over the file
+        std::vector<AggregateResult> results = run_aggregates(file.data(), specs);
+        for (size_t i = 0; i < specs.size(); ++i) {
+            std::cout << specs[i].text << ":";
+            if (!results[i].ok) {
+                std::cout << " unknown column";
+            }
+            for (const AggregateValue& value : results[i].values) {
+                std::cout << (&value == &results[i].values[0] ? " " : ", ") << value.value;
+                if (!value.label.empty()) {
+                    std::cout << " (" << results[i].labelColumn << " " << value.label << ")";
+                }
+            }
+            std::cout << std::endl;
         }
+        return 0;
+    } else {
+        std::cerr << "Usage: " << argv[0] << " [--mode=stream|mmap|simd|schema|gzip|parallel|pipe|watch|batch|aggregate] [--threads=N] [--every-rows=N] [--every-ms=T] [--state=PATH] [--once] [--io=uring|threads] [--aggregates=LIST] [file...]" << std::endl;
+        return 1;
     }
 
-    file.close();
-
-    std::cout << "Day with the smallest temperature spread: " << minSpreadDay << std::endl;
+    std::cout << "Day with the smallest temperature spread: " << result.day << std::endl;
     return 0;
 }
@@ -0,0 +1,58 @@
+#include <iostream>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "table_cache.h"
+
+// Prints the label of the first row with the smallest |a - b|. Returns false
+// if the file or a column is missing.
+static bool answer(const std::string& what, const std::string& path, const std::string& label, const std::string& a,
+                   const std::string& b, bool useCache) {
+    std::optional<Table> table = load_table(path, useCache);
+    if (!table) {
+        std::cerr << "Failed to open file " << path << "." << std::endl;
+        return false;
+    }
+
+    const Column* labels = table->find(label);
+    const Column* columnA = table->find(a);
+    const Column* columnB = table->find(b);
+    if (!labels || !columnA || !columnB) {
+        std::cerr << "Missing column in " << path << "." << std::endl;
+        return false;
+    }
+
+    std::optional<size_t> row = min_abs_difference(*columnA, *columnB);
+    std::cout << what << ": " << (row ? labels->text(*row) : "none") << std::endl;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    bool useCache = true;
+    std::vector<std::string> args;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--no-cache") {
+            useCache = false;
+        } else {
+            args.push_back(arg);
+        }
+    }
+
+    if (args.size() == 4) {
+        return answer(args[1] + " with the smallest |" + args[2] + " - " + args[3] + "|", args[0], args[1], args[2],
+                      args[3], useCache)
+                   ? 0
+                   : 1;
+    }
+    if (!args.empty()) {
+        std::cerr << "Usage: " << argv[0] << " [--no-cache] [file label column column]" << std::endl;
+        return 1;
+    }
+
+    // The kata's two questions, answered by the same table code.
+    bool ok = answer("Day with the smallest temperature spread", "data/weather.dat", "Dy", "MxT", "MnT", useCache);
+    ok = answer("Team with the smallest goal difference", "data/football.dat", "Team", "F", "A", useCache) && ok;
+    return ok ? 0 : 1;
+}
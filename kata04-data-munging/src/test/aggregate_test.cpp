@@ -0,0 +1,69 @@
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "aggregate.h"
+
+// Checked in every build type, unlike assert, which NDEBUG turns off.
+int failures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl; \
+            ++failures; \
+        } \
+    } while (false)
+
+// The monthly summary row has the largest spread and the highest maximum,
+// so it would win the max and the top-k if it were read as a day.
+const char* const WEATHER =
+    "  Dy MxT   MnT\n"
+    "\n"
+    "   1  88    59\n"
+    "   2  79*   63\n"
+    "   3  77    55\n"
+    "  mo  99    10\n";
+
+const char* const FOOTBALL =
+    "       Team            F      A\n"
+    "    1. Arsenal         79  -  36\n"
+    "    2. Liverpool       67  -  30\n"
+    "   -------------------------------\n"
+    "    3. Manchester_U    87  -  45\n";
+
+std::vector<AggregateResult> run(const char* text, const std::vector<std::string>& texts) {
+    std::vector<AggregateSpec> specs;
+    for (const std::string& spec : texts) {
+        specs.push_back(*parse_aggregate(spec));
+    }
+    return run_aggregates(text, specs);
+}
+
+void run_summary_row_tests() {
+    std::vector<AggregateResult> results = run(WEATHER, {"max:MxT-MnT", "top2:MxT", "min:MnT", "avg:MnT"});
+    for (const AggregateResult& result : results) {
+        CHECK(result.ok && result.labelColumn == "Dy" && result.rows == 3);
+    }
+    CHECK(results[0].values.size() == 1 && results[0].values[0].value == 29 && results[0].values[0].label == "1");
+    CHECK(results[1].values.size() == 2 && results[1].values[0].label == "1" && results[1].values[1].label == "2");
+    CHECK(results[2].values.size() == 1 && results[2].values[0].value == 55 && results[2].values[0].label == "3");
+    CHECK(results[3].values.size() == 1 && results[3].values[0].value == 59);
+}
+
+void run_string_label_tests() {
+    std::vector<AggregateResult> results = run(FOOTBALL, {"max:F", "min:A"});
+    CHECK(results[0].ok && results[0].labelColumn == "Team" && results[0].rows == 3);
+    CHECK(results[0].values.size() == 1 && results[0].values[0].value == 87 && results[0].values[0].label == "Manchester_U");
+    CHECK(results[1].values.size() == 1 && results[1].values[0].value == 30 && results[1].values[0].label == "Liverpool");
+}
+
+int main() {
+    run_summary_row_tests();
+    run_string_label_tests();
+    if (failures) {
+        return 1;
+    }
+    std::cout << "All tests passed" << std::endl;
+    return 0;
+}